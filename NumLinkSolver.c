@@ -1,6 +1,22 @@
 #include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <limits.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
 #include <memory.h>
 #include <errno.h>
+#include <signal.h>
+#include <poll.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
 #include "Utils.h"
 
 //#define DEBUG 1
@@ -12,6 +28,8 @@
 #define MIN_POINTS 2
 #define MAX_POINTS 29
 #define MAX_PARTS 63
+#define MAX_PATHS MAX_PARTS
+#define MAX_PATH_POINTS (MAX_SIZE * MAX_SIZE)
 
 #define STAT_LEN 3
 #define LINK_NAME_LEN 2
@@ -20,6 +38,30 @@
 #define AROUND_CNT 8
 #define SPLIT_PAT_CNT 256
 
+// 8}X̍ǂASǂƕf邩߂
+// 󂫃}X̘AȂ̂A㉺Ẽ}X܂ނ̂2ȏ゠Εf
+#define AROUND_BIT(pat, i)		(((pat) >> ((i) & 0x07)) & 1)
+#define SPLIT_RUN(pat, i)		( \
+	!AROUND_BIT(pat, i) && AROUND_BIT(pat, (i) + 7) \
+	&& (((i) & 1) == 0 || !AROUND_BIT(pat, (i) + 1)) \
+)
+#define IS_SPLIT_PAT(pat)		( \
+	SPLIT_RUN(pat, 0) + SPLIT_RUN(pat, 1) + SPLIT_RUN(pat, 2) + SPLIT_RUN(pat, 3) \
+	+ SPLIT_RUN(pat, 4) + SPLIT_RUN(pat, 5) + SPLIT_RUN(pat, 6) + SPLIT_RUN(pat, 7) >= 2 \
+)
+#define SPLIT_PAT_4(pat)		IS_SPLIT_PAT(pat), IS_SPLIT_PAT((pat) + 1), IS_SPLIT_PAT((pat) + 2), IS_SPLIT_PAT((pat) + 3)
+#define SPLIT_PAT_16(pat)		SPLIT_PAT_4(pat), SPLIT_PAT_4((pat) + 4), SPLIT_PAT_4((pat) + 8), SPLIT_PAT_4((pat) + 12)
+#define SPLIT_PAT_64(pat)		SPLIT_PAT_16(pat), SPLIT_PAT_16((pat) + 16), SPLIT_PAT_16((pat) + 32), SPLIT_PAT_16((pat) + 48)
+#define SPLIT_PAT_256(pat)		SPLIT_PAT_64(pat), SPLIT_PAT_64((pat) + 64), SPLIT_PAT_64((pat) + 128), SPLIT_PAT_64((pat) + 192)
+
+// 3x3 ŕfƔ肳ꂽ}X 5x5 ͈̔͂ŉIHT
+#define WINDOW_RADIUS 2
+#define WINDOW_WIDTH (WINDOW_RADIUS * 2 + 1)
+#define WINDOW_CENTER (WINDOW_WIDTH * WINDOW_RADIUS + WINDOW_RADIUS)
+#define WINDOW_PAT_CNT (1 << (WINDOW_WIDTH * WINDOW_WIDTH - 1))
+#define WINDOW_COL0 0x0108421
+#define WINDOW_ALL 0x1ffffff
+
 #define RET_OK 0
 #define RET_NG -1
 
@@ -37,6 +79,7 @@
 #define DIR_DOWN 1
 #define DIR_LEFT 2
 #define DIR_UP 3
+#define DIR_NONE -1
 
 #define H_WALL "---"
 #define DOWN_MARK " v "
@@ -68,14 +111,174 @@
 #define DEBUG_DUMP(ptr, size)
 #endif
 
+// R}hCfobO\炾ĂԊ֐́AgW[ʏ̃rhł͎gȂƂ
+#define MAY_BE_UNUSED __attribute__((unused))
+
 #define LINE_BUF_LEN 255
 
-#define _consume_char(ptr) (*(ptr++) = '\0')
-#define _consume_space(ptr) while (isspace(*ptr)) { _consume_char(ptr); }
-#define _consume_delim(ptr) _consume_char(ptr); _consume_space(ptr)
-#define _get_token(ptr, chr) while (*ptr != '\0' && !isspace(*ptr) && *ptr != chr) { ptr++; } _consume_space(ptr)
-#define _get_number(ptr) while (*ptr != '\0' && isdigit(*ptr)) { ptr++; } _consume_space(ptr)
+#define MAX_DEPTH (MAX_SIZE * MAX_SIZE)
+#define CHECK_INTERVAL 1024
+
+#define CKPT_MAGIC "NLCP"
+#define CKPT_VERSION 9
+#define CKPT_INTERVAL 10
+
+#define TRACE_MAGIC "NLTR"
+#define TRACE_VERSION 1
+#define TRACE_BUF_CNT 4096
+#define TRACE_HOT_DEPTH 16
+
+// L^̎ ([͎Iԑ̃m[h̐[)
+#define TRACE_ROOT 0
+#define TRACE_MOVE 1
+#define TRACE_BACK 2
+#define TRACE_PRUNE 3
+#define TRACE_SOLVED 4
+#define TRACE_ARG(part, dir)	((unsigned char) ((dir) | ((part) << 2)))
+#define TRACE_PART(arg)			((arg) >> 2)
+#define TRACE_EVENT(event, arg) \
+  do { if (gpstTraceFile != NULL) { add_trace(event, arg); } } while (0)
+
+// }̗R (i\̃JE^Ɠ)
+#define PRUNE_BRANCH 0
+#define PRUNE_DEAD_END 1
+#define PRUNE_DEAD_PARTITION 2
+#define PRUNE_SPLIT_LINK 3
+#define PRUNE_PARITY 4
+#define PRUNE_CORRIDOR 5
+#define PRUNE_UNREACHABLE 6
+#define PRUNE_SHORT_LENGTH 7
+#define PRUNE_FD1_DEAD_PARTITION 8
+#define PRUNE_MULTI_SPLIT 9
+#define PRUNE_NOGOOD 10
+#define PRUNE_SYMMETRY 11
+#define PRUNE_CNT 12
+#define PRUNE_EVENT(reason) \
+  do { \
+    if (gcProfile == FLG_ON) { add_profile_prune(reason); } \
+    TRACE_EVENT(TRACE_PRUNE, reason); \
+  } while (0)
+
+// [Ɩ܂}X̊Ƃ̏Wv (--profile, --auto-tune)
+#define PROFILE_FILL_CNT 10
+#define TUNE_MIN_CALLS 128
+#define TUNE_SAVED_NODES 16
+
+// dׂ̊Ԉ (--schedule)
+#define SCHED_PARTITION 0
+#define SCHED_FORWARD1 1
+#define SCHED_CHECK_CNT 2
+#define SCHED_WINDOW 1024
+#define SCHED_MAX_INTERVAL 8
+
+#define MOVE_DIR(move)			((move) & 0x03)
+#define MOVE_TRIED(move)		(((move) >> 2) & 0x0f)
+#define MAKE_MOVE(dir, tried)	((char) ((dir) | ((tried) << 2)))
+
+#define STOP_NONE 0
+#define STOP_SOLVED 1
+#define STOP_NODES 2
+#define STOP_TIME 3
+#define STOP_MEMORY 4
+#define STOP_CANCEL 5
+#define STOP_RESTART 6
+
+#define ALL_PARTS (~0ULL)
+#define MAX_JOBS 64
+#define PARALLEL_MIN_PARTS 3
+#define PARALLEL_POLL_MSEC 100
+
+#define RESTART_NONE 0
+#define RESTART_LUBY 1
+#define RESTART_GEOMETRIC 2
+#define RESTART_BASE 1000
+#define MAX_PORTFOLIO 64
+
+#define MAX_DIST 64
+#define DIST_SPLIT_DEPTH 8
+#define DIST_TASK_STEP 4096
+#define DIST_STOP_MSEC 2000
+
+#define ARENA_ALIGN 64
+#define ARENA_ROUND(size) (((size) + ARENA_ALIGN - 1) & ~((long) ARENA_ALIGN - 1))
+#define ARENA_FRAMES (MAX_DEPTH * 3)
+
+#define ORDER_FIXED 0
+#define ORDER_PARTNER 1
+#define ORDER_WALL 2
+#define ORDER_EXITS 3
+#define ORDER_HISTORY 4
+
+#define NOGOOD_BITS 16
+#define NOGOOD_CNT (1 << NOGOOD_BITS)
+#define NOGOOD_MASK (NOGOOD_CNT - 1)
+#define NOGOOD_CHECK_SALT 0x2545f4914f6cdd1dULL
+
+#define INCR_MAGIC "NLIS"
+#define INCR_VERSION 3
+#define INCR_RADIUS 2
+
+#define CACHE_MAGIC "NLRC"
+#define CACHE_VERSION 2
+#define CACHE_BITS 12
+#define CACHE_CNT (1 << CACHE_BITS)
+#define CACHE_MASK (CACHE_CNT - 1)
+#define CACHE_NO_PRESOLVE 0x01
+#define CACHE_NO_SYMMETRY 0x02
+#define CACHE_AUTO_TUNE 0x04
+#define CACHE_SCHEDULE 0x08
+#define CACHE_NO_NOGOOD 0x10
+#define SYM_CNT 8
+#define LINK_ID_CNT 100
+#define CELL_LINK(cell)			((cell) & 0x3f)
+#define CELL_DIR(cell)			(((cell) >> 6) & 0x03)
+#define MAKE_CELL(link, dir)	((unsigned char) ((link) | ((dir) << 6)))
+
+#define BIN_MAGIC "NLBF"
+#define BIN_VERSION 1
+#define BIN_HEADER_LEN 8
+#define BIN_FOOTER_LEN 16
+#define BIN_INDEX_STEP 64
+#define BIN_NONE 0
+#define BIN_SOLVED 1
+#define BIN_UNSAT 2
+#define BIN_NAME_MASK 0x7f
+#define BIN_NAME_ZERO 0x80
+#define BIN_CODE_LEN(size) (((size) * (size) + 3) / 4)
+#define BIN_RECORD_LEN (6 + MAX_DEFS * (2 + MAX_POINTS) + MAX_PATHS * (2 + MAX_PATH_POINTS) + BIN_CODE_LEN(MAX_SIZE))
+
+#define FORMAT_ASCII 0
+#define FORMAT_DIRS 1
+#define FORMAT_JSON 2
+#define FORMAT_BINARY 3
+#define RENDER_BUF_LEN 8192
+#define COUNTER_CNT ((int) (sizeof(gppcCounterNames) / sizeof(gppcCounterNames[0])))
+
+#define EXIT_SOLVED 0
+#define EXIT_UNSAT 1
+#define EXIT_BUDGET 2
+#define EXIT_CANCEL 3
+#define EXIT_ERROR 4
+
+#define SERVER_WORKERS 4
+#define MAX_WORKERS 64
+#define SERVER_BACKLOG 16
+#define MAX_CLIENTS 64
+
+#define CONN_FREE 0
+#define CONN_IDLE 1
+#define CONN_QUEUED 2
+#define CONN_SOLVING 3
+#define REQUEST_NAME "request"
+
+#define _skip_space(ptr, end) while (ptr < end && isspace(*ptr)) { ptr++; }
+#define _skip_delim(ptr, end) ptr++; _skip_space(ptr, end)
+#define _skip_token(ptr, end) while (ptr < end && !isspace(*ptr)) { ptr++; }
+#define _skip_number(ptr, end) while (ptr < end && isdigit(*ptr)) { ptr++; }
+#define _is_token(ptr, len, str) ((len) == (int) strlen(str) && memcmp(ptr, str, len) == 0)
+#define _rest(ptr, end) (int) (end - ptr), ptr
 #define _parse_error(fmt, ...) printf("%s(%d) : " fmt, pcFileName, iLineCnt, ##__VA_ARGS__)
+#define _bin_error(fmt, ...) printf("%s(#%ld) : " fmt, pstBin->pcFileName, iRecord, ##__VA_ARGS__)
 
 
 typedef struct __POINT {
@@ -88,6 +291,40 @@ typedef struct __LINK_DEF {
 	POINT pstPoints[MAX_POINTS + 1];
 } LINK_DEF, *pLINK_DEF;
 
+typedef struct __PATH_DEF {
+	char pcLinkName[STAT_LEN + 1];
+	POINT pstPoints[MAX_PATH_POINTS + 1];
+} PATH_DEF, *pPATH_DEF;
+
+typedef struct __BIN_FILE {
+	const char *pcFileName;
+	const unsigned char *pbBuf;
+	const unsigned char *pbIndex;
+	long iLen;
+	long iCount;
+} BIN_FILE, *pBIN_FILE;
+
+typedef struct __BIN_WRITER {
+	FILE *pstFile;
+	unsigned long lOffset;
+	long iCount;
+	unsigned long *plIndex;
+	long iIndexCap;
+} BIN_WRITER, *pBIN_WRITER;
+
+typedef struct __BATCH_STATS {
+	pBIN_WRITER pstWriter;
+	char cConvert;
+	int iLineCnt;
+	int iPuzzles;
+	int iSolved;
+	int iUnsat;
+	int iBudget;
+	int iCanceled;
+	int iErrors;
+	int iExitCode;
+} BATCH_STATS, *pBATCH_STATS;
+
 typedef struct __LINK_PART {
 	char pcLinkName[STAT_LEN + 1];
 	POINT stStart;
@@ -100,11 +337,24 @@ typedef struct __LINK_PART {
 typedef struct __STATUS {
 	LINK_PART pstLinkParts[MAX_PARTS + 1];
 	char pppcStats[MAX_SIZE][MAX_SIZE][STAT_LEN + 1];
-	char pppcHwalls[MAX_SIZE][MAX_SIZE][STAT_LEN + 1];
-	char pppcVwalls[MAX_SIZE][MAX_SIZE][1 + 1];
+	char ppcDirs[MAX_SIZE][MAX_SIZE];
 	char ppcFd1Flags[MAX_SIZE][MAX_SIZE];
 } STATUS, *pSTATUS;
 
+typedef struct __PROBE {
+	STATUS stStatus;
+	char ppcExitPoints[MAX_SIZE][MAX_SIZE];
+	int piColorDiffs[MAX_SIZE * MAX_SIZE];
+	unsigned long long plActiveParts[MAX_SIZE * MAX_SIZE];
+} PROBE, *pPROBE;
+
+typedef struct __ARENA {
+	char *pcBase;
+	long iSize;
+	long iTop;
+	long iPeak;
+} ARENA, *pARENA;
+
 typedef struct __DIRECTION {
 	char pcDirMark[STAT_LEN + 1];
 	char cRowDelta;
@@ -116,6 +366,147 @@ typedef struct __NEIGHBOR {
 	POINT stPoint;
 } NEIGHBOR, *pNEIGHBOR;
 
+typedef struct __TRACE_HEADER {
+	char pcMagic[4];
+	char cVersion;
+	char cSize;
+	short sStatusLen;
+} TRACE_HEADER, *pTRACE_HEADER;
+
+typedef struct __TRACE_REC {
+	unsigned char cEvent;
+	unsigned char cArg;
+	short sDepth;
+} TRACE_REC, *pTRACE_REC;
+
+typedef struct __PROFILE_BIN {
+	long iNodes;
+	long plPrunes[PRUNE_CNT];
+	long iPartitionNsec;
+	long iForward1Nsec;
+	long iForward1Calls;
+	long iForward1Prunes;
+} PROFILE_BIN, *pPROFILE_BIN;
+
+typedef struct __SCHED_STAT {
+	long iCalls;
+	long iPrunes;
+	long iNsec;
+	int iWait;
+} SCHED_STAT, *pSCHED_STAT;
+
+typedef struct __CHECKPOINT {
+	char pcMagic[4];
+	char cVersion;
+	char cSize;
+	short sDepth;
+	unsigned long lDefHash;
+	long iElapsed;
+	long iNodeCases;
+	long iOkCases;
+	long iBranchErrCases;
+	long iDeadEndCases;
+	long iDeadPartitionCases;
+	long iSplitLinkCases;
+	long iFd1DeadPartitionCases;
+	long iMultiSplitCases;
+	long iCorridorCases;
+	long iUnreachableCases;
+	long iShortLengthCases;
+	long iParityCases;
+	long iGroupCases;
+	long iGroupCutCases;
+	long iNogoodCases;
+	long iRestartCases;
+	long iSymmetryCases;
+} CHECKPOINT, *pCHECKPOINT;
+
+typedef struct __GROUP_FRAME {
+	unsigned long long plGroups[MAX_PARTS];
+	char cGroupCnt;
+	char cCurrent;
+	unsigned long long lSavedFocus;
+	int iParent;
+	long iDoneCnt;
+} GROUP_FRAME, *pGROUP_FRAME;
+
+typedef struct __NOGOOD {
+	unsigned long long lKey;
+	unsigned long long lCheck;
+} NOGOOD, *pNOGOOD;
+
+typedef struct __CHILD_RESULT {
+	char cStopReason;
+	STATUS stStatus;
+	CHECKPOINT stCounters;
+	long iSolutionCases;
+} CHILD_RESULT, *pCHILD_RESULT;
+
+typedef struct __INCR_STATE {
+	char pcMagic[4];
+	char cVersion;
+	char cSize;
+	char cSolved;
+	LINK_DEF pstLinkDefs[MAX_DEFS + 1];
+	STATUS stSolution;
+	unsigned long lDefHash;
+	NOGOOD pstNogoods[NOGOOD_CNT];
+} INCR_STATE, *pINCR_STATE;
+
+typedef struct __CACHE_ENTRY {
+	unsigned long lKey;
+	char cSize;
+	char cResult;
+	char cMode;
+	LINK_DEF pstLinkDefs[MAX_DEFS + 1];
+	unsigned char ppcCells[MAX_SIZE][MAX_SIZE];
+} CACHE_ENTRY, *pCACHE_ENTRY;
+
+typedef struct __CACHE_FILE {
+	char pcMagic[4];
+	char cVersion;
+	CACHE_ENTRY pstEntries[CACHE_CNT];
+} CACHE_FILE, *pCACHE_FILE;
+
+typedef struct __CLIENT {
+	int iFd;
+	int iLen;
+	char cClosed;
+	char pcBuf[LINE_BUF_LEN + 1];
+} CLIENT, *pCLIENT;
+
+typedef struct __CONNECTION {
+	CLIENT stClient;
+	char cState;
+	long iQueueNo;
+} CONNECTION, *pCONNECTION;
+
+typedef struct __WORKER {
+	pid_t iPid;
+	int iFd;
+	int iConn;
+} WORKER, *pWORKER;
+
+typedef struct __HANDOFF {
+	char cClosed;
+	int iLen;
+	char pcBuf[LINE_BUF_LEN];
+} HANDOFF, *pHANDOFF;
+
+typedef struct __SERVER_STATS {
+	time_t tStartTime;
+	long iRequests;
+	long iSolved;
+	long iUnsat;
+	long iBudget;
+	long iCanceled;
+	long iErrors;
+	long iNodes;
+	long iBusy;
+	long iQueued;
+	long iClients;
+} SERVER_STATS, *pSERVER_STATS;
+
 static DIRECTION gpstDirections[] = {
 	{RIGHT_MARK, 0,  1},
 	{DOWN_MARK,  1,  0},
@@ -134,23 +525,26 @@ static DIRECTION gpstArounds[] = {
 	{ "", -1,  1}
 };
 
-static int gpiSplitPatterns[] = {
-	9,10,11,17,18,19,25,26,27,
-	33,34,35,36,37,38,39,40,41,42,43,44,45,46,47,49,50,51,57,58,59,
-	66,68,70,72,73,74,75,76,77,78,82,
-	98,100,102,104,105,106,107,108,110,114,122,
-	130,132,134,136,137,138,139,140,142,144,145,146,147,148,150,152,153,154,155,156,158,
-	160,161,162,163,164,165,166,167,168,169,170,171,172,173,174,175,176,177,178,179,180,182,184,185,186,187,188,190,
-	194,196,198,200,201,202,203,204,206,210,
-	226,228,230,232,233,234,235,236,238,242,250,
-	-1
+static const char gpcSplitPatternTbl[SPLIT_PAT_CNT] = {
+	SPLIT_PAT_256(0)
 };
 
-static char gpcSplitPatternTbl[SPLIT_PAT_CNT];
+// 5x5 ̔茋 (߂̂珇Ɋo)
+static unsigned char gpcWindowKnown[WINDOW_PAT_CNT / 8];
+static unsigned char gpcWindowCut[WINDOW_PAT_CNT / 8];
 static char gppcZeroExitPoints[MAX_SIZE][MAX_SIZE];
 
 static char gcSize;
 static LINK_DEF gpstLinkDefs[MAX_DEFS + 1];
+static PATH_DEF gpstPathDefs[MAX_PATHS + 1];
+static char gpcDefIds[LINK_ID_CNT];
+static unsigned char gpcDefCells[(MAX_SIZE * MAX_SIZE + 7) / 8];
+static char gcDefCnt;
+static char gcPathCnt;
+static char gcBatch;
+static char *gpcOutputFile;
+static char *gpcConvertFile;
+static long giRecord;
 
 //static char gcSize = 7;
 //LINK_DEF gpstLinkDefs[] = {
@@ -163,6 +557,7 @@ static LINK_DEF gpstLinkDefs[MAX_DEFS + 1];
 //};
 
 static time_t gtStartTime;
+static long giNodeCases;
 static long giOkCases;
 static long giBranchErrCases;
 static long giDeadEndCases;
@@ -170,19 +565,372 @@ static long giDeadPartitionCases;
 static long giSplitLinkCases;
 static long giFd1DeadPartitionCases;
 static long giMultiSplitCases;
+static long giCorridorCases;
+static long giUnreachableCases;
+static long giShortLengthCases;
+static long giParityCases;
+static long giGroupCases;
+static long giGroupCutCases;
+static long giNogoodCases;
+static long giRestartCases;
+static long giSymmetryCases;
+
+// o߂̍s JSON ɕׂJE^
+static const char *gppcCounterNames[] = {
+	"br", "de", "dp", "sl", "pr", "cr", "ur", "ln", "fdp", "msl", "gr", "gc", "ng", "rs", "sy", "ok"
+};
+static long *gppiCounters[] = {
+	&giBranchErrCases,
+	&giDeadEndCases,
+	&giDeadPartitionCases,
+	&giSplitLinkCases,
+	&giParityCases,
+	&giCorridorCases,
+	&giUnreachableCases,
+	&giShortLengthCases,
+	&giFd1DeadPartitionCases,
+	&giMultiSplitCases,
+	&giGroupCases,
+	&giGroupCutCases,
+	&giNogoodCases,
+	&giRestartCases,
+	&giSymmetryCases,
+	&giOkCases
+};
 
-static char read_def(
+static char *gpcDefFileName;
+static char *gpcCheckpointFile;
+static char *gpcResumeFile;
+static int giCheckpointInterval;
+static time_t gtCheckpointTime;
+
+static long giMaxNodes;
+static double gdTimeLimit;
+static long giMaxMemory;
+static double gdDeadline;
+static long giNextCheck;
+static char gcStopReason;
+static volatile sig_atomic_t gcCancel;
+static STATUS gstSolution;
+static char gcQuiet;
+
+static char *gpcSocketPath;
+static int giWorkers;
+static pSERVER_STATS gpstServerStats;
+static WORKER gpstWorkers[MAX_WORKERS];
+static CONNECTION gpstConnections[MAX_CLIENTS];
+static long giQueueNo;
+static pCLIENT gpstClient;
+static volatile sig_atomic_t gcShutdown;
+
+// T̎菇 ([Ƃ̕Ǝsςݕ)
+static char gpcMoves[MAX_DEPTH];
+static int giDepth;
+static int giResumeDepth;
+
+// ƗV}̃O[vƂɕĉ
+static GROUP_FRAME gpstFrames[MAX_DEPTH];
+static int giFrameCnt;
+static int giActiveFrame;
+static int giCutFrame;
+static unsigned long long glFocusParts;
+static int giJobs;
+static char gcGroupChild;
+
+// ؂̍܂ł̎菇zāA[J[̃vZXŉ
+static int giDistribute;
+static int giSplitDepth;
+static char gcSplit;
+static int giTaskDepth;
+static unsigned char *gpbTasks;
+static long giTaskLen;
+static long giTaskCap;
+static int giTaskCnt;
+
+// ƌ߂Ǝ}̋L^ (--trace) ƁA̓ǂݕԂ (--replay)
+static char *gpcTraceFile;
+static FILE *gpstTraceFile;
+static TRACE_REC gpstTraceBuf[TRACE_BUF_CNT];
+static int giTraceLen;
+static char gcPruneReason;
+static char *gpcReplayFile;
+static long giReplayAt;
+static const char *gppcPruneNames[] = {
+	"br", "de", "dp", "sl", "pr", "cr", "ur", "ln", "fdp", "msl", "ng", "sy"
+};
+
+// [ƁE܂}X̊Ƃ̃m[hƎ}ƒׂ̎
+static char *gpcProfileFile;
+static char gcProfile;
+static char gcAutoTune;
+static PROFILE_BIN gpstDepthBins[MAX_DEPTH + 1];
+static PROFILE_BIN gpstFillBins[PROFILE_FILL_CNT];
+static int giRootFilled;
+static char gpcFd1Off[MAX_DEPTH + 1];
+
+// [Ƃׂ̒̓ƏdAdׂm[hɍs߂
+static char gcSchedule;
+static SCHED_STAT gppstSchedStats[MAX_DEPTH + 1][SCHED_CHECK_CNT];
+static long gplSchedSkips[SCHED_CHECK_CNT];
+static char gcLastCut;
+static int giLastDepth;
+static pSTATUS gppstSchedPath[MAX_DEPTH + 1];
+static char gpcSchedSkipped[MAX_DEPTH + 1];
+static int giSchedCut;
+
+// T̔Ֆʂ̎ʂƒחp̍Ɨ̈́AɎ̈悩ςŎg
+static ARENA gstArena;
+static pPROBE gpstProbe;
+
+// T̗ƍĎn
+static char gcRandomize;
+static unsigned long glSeed;
+static unsigned long long glRandom;
+static char gcRestart;
+static long giRestartBase;
+static long giRestartLimit;
+static int giPortfolio;
+static char gpcPartOrder[MAX_PARTS];
+static char gcPartCnt;
+
+static char gcPresolve;
+
+// Ֆʂۂ]E] (rbg) ƁAグ̏d
+static char gcSymmetry;
+static char gcSymMask;
+static char gcCount;
+static long giSolutionCases;
+static long glWeight;
+static char gcSymPending;
+static char gcSymFirst;
+static char gcSymPairSym;
+static POINT gstSymHead;
+static POINT gstSymPair;
+static char gcSymPairLines;
+
+// ̃}X
+static const char *gppcOrderNames[] = {
+	"fixed",
+	"partner",
+	"wall",
+	"exits",
+	"history",
+	NULL
+};
+static char gcOrder;
+
+// o͌`Əop̗̈
+static const char *gppcFormatNames[] = {
+	"ascii",
+	"dirs",
+	"json",
+	"binary",
+	NULL
+};
+static char gcFormat;
+static char gpcRender[RENDER_BUF_LEN];
+static int giRenderLen;
+static BIN_WRITER gstFormatWriter;
+static long gpppiHistory[MAX_SIZE][MAX_SIZE][NEIGHBOR_CNT];
+
+// Ȃƕ (󂫃}Xƒ[_̑g) ̃nbV
+static char gcNogood;
+static NOGOOD gpstNogoods[NOGOOD_CNT];
+static unsigned long long gpplCellKeys[MAX_SIZE][MAX_SIZE];
+
+// ỎƎs\ (--incremental)
+static char *gpcIncrementalFile;
+static INCR_STATE gstIncrState;
+
+// ]E]Ɣԍ̕tւ𐳋Kʂ̕ۑ (--cache)
+static char *gpcCacheFile;
+static pCACHE_FILE gpstCache;
+static LINK_DEF gpstCanonDefs[MAX_DEFS + 1];
+static char gcCanonSym;
+static char gpcCanonIndex[MAX_DEFS];
+static char gpcCanonReversed[MAX_DEFS];
+
+static MAY_BE_UNUSED char parse_args(
+	int argc,
+	char **argv
+);
+static MAY_BE_UNUSED char read_def(
 	const char* pcFileName
 );
+static char map_def(
+	const char *pcFileName,
+	char **ppcBuf,
+	long *piLen
+);
+static void unmap_def(
+	char *pcBuf,
+	long iLen
+);
+static MAY_BE_UNUSED int solve_batch(
+	const char *pcFileName
+);
+static void solve_batch_def(
+	pBATCH_STATS pstBatch,
+	char cParsed
+);
+static char parse_lines(
+	const char *pcBuf,
+	const char *pcBufEnd,
+	const char *pcFileName,
+	pBATCH_STATS pstBatch
+);
+static char is_size_line(
+	const char *pcLine,
+	const char *pcLineEnd
+);
+static char is_blank_line(
+	const char *pcLine,
+	const char *pcLineEnd
+);
+static void clear_def(void);
 static void chop(
 	char *pcLine
 );
 static char parse_line(
-	char *pcLineBuf,
+	const char *pcLinePtr,
+	const char *pcLineEnd,
+	const char *pcFileName,
+	int iLineCnt
+);
+static char parse_link_name(
+	const char **ppcLinePtr,
+	const char *pcLineEnd,
+	const char **ppcLinkName,
+	int *piLinkNameLen,
 	const char *pcFileName,
 	int iLineCnt
 );
-static void init_globals();
+static char parse_point(
+	const char **ppcLinePtr,
+	const char *pcLineEnd,
+	pPOINT pstPoint,
+	const char *pcFileName,
+	int iLineCnt
+);
+static int parse_int(
+	const char *pcPtr,
+	const char *pcEnd
+);
+static char is_bin_def(
+	const char *pcBuf,
+	long iLen
+);
+static char open_bin(
+	pBIN_FILE pstBin,
+	const char *pcFileName,
+	const char *pcBuf,
+	long iLen
+);
+static const unsigned char *seek_bin(
+	pBIN_FILE pstBin,
+	long iRecord
+);
+static char read_bin(
+	pBIN_FILE pstBin,
+	const unsigned char **ppbRec,
+	long iRecord,
+	char *pcResult,
+	pPATH_DEF pstSolution
+);
+static char open_bin_writer(
+	pBIN_WRITER pstWriter,
+	const char *pcFileName
+);
+static void init_bin_writer(
+	pBIN_WRITER pstWriter,
+	FILE *pstFile
+);
+static char write_bin(
+	pBIN_WRITER pstWriter,
+	char cResult
+);
+static char close_bin_writer(
+	pBIN_WRITER pstWriter
+);
+static MAY_BE_UNUSED int convert_def(
+	const char *pcFileName,
+	const char *pcOutFile
+);
+static void write_text_def(
+	FILE *pstFile,
+	pPATH_DEF pstSolution
+);
+static unsigned long get_le(
+	const unsigned char *pbBuf,
+	int iBytes
+);
+static void set_le(
+	unsigned char *pbBuf,
+	unsigned long lValue,
+	int iBytes
+);
+static char get_bin_result(void);
+static void init_tables(void);
+static void init_arena(void);
+static void *alloc_arena(
+	long iSize
+);
+static void reset_arena(void);
+static void init_globals(void);
+static char solve(void);
+static char solve_once(void);
+static char solve_incremental(
+	const char *pcFileName
+);
+static void reset_search(void);
+static char get_automorphisms(
+	pSTATUS pstStatus
+);
+static char is_automorphism(
+	pSTATUS pstStatus,
+	char cSym
+);
+static char get_sym_stabilizer(
+	pPOINT pstPoint,
+	char cSymMask
+);
+static int get_sym_orbit(
+	pNEIGHBOR pstNeighbors,
+	pNEIGHBOR pstNeighbor,
+	char cSymMask,
+	char *pcFixMask
+);
+static char is_covered(
+	pSTATUS pstStatus
+);
+static char get_sym_pair_dir(
+	pSTATUS pstStatus,
+	char *pcDir
+);
+static char get_sym_pair_lines(
+	pSTATUS pstStatus
+);
+static MAY_BE_UNUSED char open_cache(
+	const char *pcFileName
+);
+static char solve_cached(void);
+static void store_cache(void);
+static unsigned long get_cache_key(
+	char cMode
+);
+static char get_cache_mode(void);
+static unsigned long get_canonical_def(void);
+static void get_sym_point(
+	pPOINT pstFrom,
+	char cSym,
+	pPOINT pstTo
+);
+static int compare_points(
+	pPOINT pstPoints1,
+	pPOINT pstPoints2
+);
+static MAY_BE_UNUSED void close_format(void);
+static int get_exit_code(void);
 static char init_status(
 	pSTATUS pstStatus
 );
@@ -192,6 +940,147 @@ static void close_connected_links(
 static void answer_gen(
 	pSTATUS pstStatus
 );
+static int push_frame(
+	unsigned long long *plGroups,
+	char cGroupCnt
+);
+static void pop_frame(
+	int iFrame
+);
+static void next_group(
+	pSTATUS pstStatus
+);
+static char is_parallel(
+	unsigned long long *plGroups,
+	char cGroupCnt
+);
+static void fork_groups(
+	pSTATUS pstStatus,
+	int iFrame
+);
+static pid_t start_group(
+	pSTATUS pstStatus,
+	int iFrame,
+	int iGroup,
+	int *piFd
+);
+static char read_child(
+	int iFd,
+	pCHILD_RESULT pstResult
+);
+static void send_result(
+	int iFd
+);
+static void get_child_result(
+	pCHILD_RESULT pstResult
+);
+static void search(
+	pSTATUS pstStatus
+);
+static long presolve(
+	pSTATUS pstStatus
+);
+static long apply_paths(
+	pSTATUS pstStatus
+);
+static void get_edit_distance(
+	char ppcDist[MAX_SIZE][MAX_SIZE]
+);
+static int add_kept_paths(
+	char ppcDist[MAX_SIZE][MAX_SIZE],
+	int iRadius,
+	pPATH_DEF pstPathDef
+);
+static char get_solution_path(
+	pSTATUS pstStatus,
+	pLINK_DEF pstLinkDef,
+	pPATH_DEF pstPathDef
+);
+static char find_forced_move(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	char ppcEnds[MAX_SIZE][MAX_SIZE],
+	pNEIGHBOR pstForced
+);
+static void fill_reach(
+	pSTATUS pstStatus,
+	pPOINT pstFrom,
+	char ppcReach[MAX_SIZE][MAX_SIZE]
+);
+static void move_link(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+);
+static void move_link_end(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+);
+static void run_restarts(
+	pSTATUS pstStatus
+);
+static long get_restart_budget(
+	int iRun
+);
+static void run_portfolio(
+	pSTATUS pstStatus
+);
+static pid_t start_strategy(
+	pSTATUS pstStatus,
+	int iStrategy,
+	int *piFd
+);
+static void run_distributed(
+	pSTATUS pstStatus
+);
+static void merge_dist_result(
+	pCHILD_RESULT pstResult,
+	pCHECKPOINT pstLast,
+	long *piLastSolutions,
+	pCHECKPOINT pstTotal
+);
+static char read_dist_result(
+	int iFd,
+	pCHILD_RESULT pstResult
+);
+static void add_task(void);
+static char send_task(
+	int iFd,
+	long *piNext
+);
+static pid_t start_dist_worker(
+	pSTATUS pstStatus,
+	struct pollfd *pstPolls,
+	int iWorker
+);
+static char read_task(
+	int iFd
+);
+static void set_part_order(
+	pSTATUS pstStatus,
+	int iRun
+);
+static void shuffle_neighbors(
+	pNEIGHBOR pstNeighbors
+);
+static void order_neighbors(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbors
+);
+static void put_first_neighbor(
+	pNEIGHBOR pstNeighbors,
+	char cDir
+);
+static long get_order_score(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+);
+static unsigned long get_random(
+	unsigned long lRange
+);
 
 static char check_branch(
 	pSTATUS pstStatus,
@@ -199,12 +1088,34 @@ static char check_branch(
 	char *pcLinkName
 );
 static char check_partition(
-	pSTATUS pstStatus
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char *pcGroupCnt
+);
+static char make_groups(
+	unsigned long long *plActiveParts,
+	int iRegionCnt,
+	unsigned long long *plGroups
 );
 static char fill_partition(
 	pSTATUS pstStatus,
 	pPOINT pstPoint,
-	char ppcExitPoints[MAX_SIZE][MAX_SIZE]
+	char ppcExitPoints[MAX_SIZE][MAX_SIZE],
+	int *piColorCnts
+);
+static char get_parity(
+	pLINK_PART pstLinkPart
+);
+
+static char check_reachable(
+	pSTATUS pstStatus
+);
+static void fill_distance(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	char ppcLinks[MAX_SIZE][MAX_SIZE],
+	char cLinkNo,
+	short ppsDists[MAX_SIZE][MAX_SIZE]
 );
 
 static char check_forward1(
@@ -223,14 +1134,19 @@ static void fill_partition_forward1(
 static void open_stat(
 	pSTATUS pstStatus,
 	pPOINT pstPoint,
-	char *pcLinkName,
-	char *pcMark
+	const char *pcLinkName,
+	const char *pcMark
 );
 static void set_stat(
 	pSTATUS pstStatus,
 	pPOINT pstPoint,
-	char *pcLinkName,
-	char *pcMark
+	const char *pcLinkName,
+	const char *pcMark
+);
+static void make_stat(
+	char *pcStat,
+	const char *pcLinkName,
+	const char *pcMark
 );
 static void close_stat(
 	pSTATUS pstStatus,
@@ -254,6 +1170,11 @@ static void set_direction(
 	pPOINT pstPoint,
 	pDIRECTION pstDir
 );
+static char get_line_dir(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	pNEIGHBOR pstNeighbor
+);
 static void get_neighbors(
 	pPOINT pstPoint,
 	pNEIGHBOR pstNeighbors
@@ -266,6 +1187,28 @@ static void close_connected_link(
 static pLINK_PART get_open_link(
 	pSTATUS pstStatus
 );
+static pLINK_PART get_focus_link(
+	pSTATUS pstStatus
+);
+static void get_nogood_key(
+	pSTATUS pstStatus,
+	pNOGOOD pstKey
+);
+static unsigned long long mix_key(
+	unsigned long long lKey
+);
+static char has_nogood_group(
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char cGroupCnt,
+	pNOGOOD pstFirstKey
+);
+static char has_nogood(
+	pNOGOOD pstKey
+);
+static void add_nogood(
+	pNOGOOD pstKey
+);
 
 static void set_fd1_point(
 	pSTATUS pstStatus,
@@ -284,14 +1227,184 @@ static char is_fd1_point(
 	pPOINT pstPoint
 );
 
-static void get_arounds(
-	pPOINT pstPoint,
-	pPOINT pstArounds
-);
 static char has_split_at(
 	pSTATUS pstStatus,
 	pPOINT pstPoint
 );
+static int get_window_pattern(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+);
+static char is_window_cut(
+	int iWindowPat
+);
+
+static double get_clock(void);
+static void set_signal(
+	int iSignal,
+	void (*pfHandler)(int)
+);
+static void on_signal(
+	int iSignal
+);
+static void check_limits(void);
+static void print_result(void);
+
+static unsigned long get_def_hash(void);
+static void check_checkpoint(void);
+static char save_checkpoint(
+	const char *pcFileName
+);
+static MAY_BE_UNUSED char load_checkpoint(
+	const char *pcFileName
+);
+static void get_counters(
+	pCHECKPOINT pstCheckpoint
+);
+static char save_state(
+	const char *pcFileName
+);
+static char load_state(
+	const char *pcFileName
+);
+static void set_counters(
+	pCHECKPOINT pstCheckpoint
+);
+static MAY_BE_UNUSED char open_trace(
+	const char *pcFileName
+);
+static void add_trace(
+	char cEvent,
+	unsigned char cArg
+);
+static void add_trace_root(
+	pSTATUS pstStatus
+);
+static void flush_trace(void);
+static MAY_BE_UNUSED void close_trace(void);
+static MAY_BE_UNUSED int replay_trace(
+	const char *pcFileName
+);
+static void replay_move(
+	pSTATUS pstStatus,
+	pTRACE_REC pstRec
+);
+static const unsigned char *next_trace(
+	const unsigned char *pbRec,
+	const unsigned char *pbEnd,
+	pTRACE_REC pstRec
+);
+static void print_prunes(
+	long *plPrunes
+);
+static char run_checks(
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char *pcGroupCnt
+);
+static char is_cut_prone(void);
+static char check_skipped(
+	int iDepthEnd
+);
+static char is_check_due(
+	char cCheck,
+	char cCutProne
+);
+static void add_check_stat(
+	char cCheck,
+	long iNsec,
+	char cRet
+);
+static void add_profile_node(void);
+static void add_profile_prune(
+	char cReason
+);
+static pPROFILE_BIN get_fill_bin(void);
+static int get_filled(
+	pSTATUS pstStatus
+);
+static void tune_forward1(
+	int iDepth
+);
+static MAY_BE_UNUSED char write_profile(
+	const char *pcFileName
+);
+static void write_profile_bin(
+	FILE *pstFile,
+	pPROFILE_BIN pstBin
+);
+
+static MAY_BE_UNUSED int run_server(
+	const char *pcSocketPath
+);
+static void on_shutdown(
+	int iSignal
+);
+static void start_worker(
+	int iWorker,
+	int iListenFd
+);
+static void worker_loop(
+	int iCtrlFd
+);
+static void accept_connection(
+	int iListenFd
+);
+static void read_connection(
+	int iConn
+);
+static void process_connection(
+	int iConn
+);
+static void dispatch_requests(void);
+static void finish_request(
+	int iWorker,
+	int iListenFd
+);
+static void close_connection(
+	int iConn
+);
+static char send_handoff(
+	int iCtrlFd,
+	pCLIENT pstClient,
+	int iFd
+);
+static char recv_handoff(
+	int iCtrlFd,
+	pCLIENT pstClient,
+	int *piFd
+);
+static char is_solve_line(
+	const char *pcLine
+);
+static char handle_command(
+	pCLIENT pstClient,
+	char *pcLine
+);
+static void handle_solve(
+	pCLIENT pstClient,
+	char *pcArgs
+);
+static char parse_solve_value(
+	const char *pcValue,
+	double *pdValue
+);
+static char read_client_line(
+	pCLIENT pstClient,
+	char *pcLine
+);
+static char read_client_bytes(
+	pCLIENT pstClient,
+	unsigned char *pbDest,
+	long iLen
+);
+static char read_client_bin(
+	pCLIENT pstClient
+);
+static char check_client(
+	pCLIENT pstClient
+);
+static void print_server_stats(void);
 
 static void print_progress(
 	pSTATUS pstStatus
@@ -302,1163 +1415,8265 @@ static void print_status(
 static void print_grid(
 	pSTATUS pstStatus
 );
+static void render_grid(
+	pSTATUS pstStatus
+);
+static void print_solution(void);
+static void render_dirs(void);
+static void render_json(void);
+static void render_profile(void);
+static void render_char(
+	char c
+);
+static void render_str(
+	const char *pcStr
+);
+static void render_pad(
+	const char *pcStr,
+	int iWidth,
+	char cLeft
+);
+static void render_int(
+	long iValue,
+	int iWidth
+);
+static void flush_render(void);
 static void print_link(
 	pLINK_PART pstLinkPart
 );
-static void print_links(
+static MAY_BE_UNUSED void print_links(
 	pLINK_PART pstLinkParts
 );
-static void print_exit(
+static MAY_BE_UNUSED void print_exit(
 	char ppcExitPoints[MAX_SIZE][MAX_SIZE]
 );
 
+// gW[ƂĎ荞ނƂ main O
+#ifndef NUMLINK_LIBRARY
 int main(int argc, char **argv) {
 
-	STATUS stStatus;
-
-	if (argc != 2) {
-		printf("usage : NumLinkSolver filename");
-		exit(0);
+	BIN_WRITER stWriter;
+	int iExitCode;
+
+	if (parse_args(argc, argv) != RET_OK) {
+		printf(
+			"usage : NumLinkSolver [options] filename\n"
+			"        NumLinkSolver [options] --server socket\n"
+			"  --checkpoint file : save the search frontier to file periodically\n"
+			"  --interval sec    : checkpoint interval in seconds (default %d)\n"
+			"  --resume file     : resume the search from checkpoint file\n"
+			"  --max-nodes n     : stop after n search nodes\n"
+			"  --time-limit sec  : stop after sec seconds\n"
+			"  --max-memory mb   : stop when the process uses mb megabytes\n"
+			"  --server socket   : serve solve requests on a unix domain socket\n"
+			"  --workers n       : number of server worker processes (default %d)\n"
+			"  --jobs n          : solve independent regions in up to n processes\n"
+			"  --seed n          : randomize the link and direction order with seed n\n"
+			"  --restart policy  : restart the search on a node schedule (luby or geometric)\n"
+			"  --restart-base n  : nodes of the first restart run (default %d)\n"
+			"  --portfolio n     : race n search strategies in separate processes\n"
+			"  --distribute n    : hand out subtrees to n worker processes\n"
+			"  --split-depth d   : depth of the subtrees handed out (default %d)\n"
+			"  --no-presolve     : skip the forced moves before the search\n"
+			"  --order policy    : direction order (fixed, partner, wall, exits or history)\n"
+			"  --incremental file: reuse and update the previous solution kept in file\n"
+			"  --cache file      : look up and store results by the shape of the puzzle\n"
+			"  --count           : count all solutions\n"
+			"  --no-symmetry     : do not skip moves that mirror a tried one\n"
+			"  --no-nogood       : do not remember groups known to have no solution\n"
+			"  --batch           : solve every puzzle in filename, each starting at a size line\n"
+			"  --output file     : write the puzzles and their solutions to the binary file\n"
+			"  --convert file    : convert filename between text and binary and write it to file\n"
+			"  --record n        : solve the n-th puzzle (from 0) of a binary filename\n"
+			"  --format type     : output format (ascii, dirs, json or binary)\n"
+			"  --trace file      : write every move, backtrack and prune to file\n"
+			"  --replay file     : summarize a trace file and its busiest subtrees\n"
+			"  --at n            : with --replay, print the board at the n-th record\n"
+			"  --profile file    : write node, prune and check time histograms by depth and fill to file\n"
+			"  --auto-tune       : skip the forward-1 check at depths where it costs more than it saves\n"
+			"  --schedule        : run the partition and forward-1 checks only as often as they pay off\n",
+			CKPT_INTERVAL,
+			SERVER_WORKERS,
+			RESTART_BASE,
+			DIST_SPLIT_DEPTH
+		);
+		exit(EXIT_ERROR);
 	}
 
-	if (read_def(argv[1]) != RET_OK) {
-		exit(0);
+	init_tables();
+
+	// T[õ[J[̈L
+	if (gpcCacheFile != NULL) {
+		if (open_cache(gpcCacheFile) != RET_OK) {
+			exit(EXIT_ERROR);
+		}
 	}
 
-	init_globals();
-	if (init_status(&stStatus) != RET_OK) {
-		exit(0);
+	if (gpcSocketPath != NULL) {
+		return run_server(gpcSocketPath);
 	}
-	close_connected_links(&stStatus);
 
-	print_status(&stStatus);
-	DEBUG_DUMP((char *) &stStatus, sizeof(stStatus));
+	if (gpcConvertFile != NULL) {
+		return convert_def(gpcDefFileName, gpcConvertFile);
+	}
 
-	answer_gen(&stStatus);
-}
+	if (gpcReplayFile != NULL) {
+		return replay_trace(gpcReplayFile);
+	}
 
-static char read_def(
-	const char* pcFileName
-) {
+	// oCi͌̕Wo͂ɏAق̃bZ[W͕WG[ɉ
+	if (gcFormat == FORMAT_BINARY) {
+		fflush(stdout);
+		init_bin_writer(&gstFormatWriter, fdopen(dup(STDOUT_FILENO), "wb"));
+		dup2(STDERR_FILENO, STDOUT_FILENO);
+	}
 
-	FILE *pstFile;
-	char pcLineBuf[LINE_BUF_LEN + 1];
-	int iLineCnt;
+	if (gcBatch == FLG_ON) {
+		set_signal(SIGINT, on_signal);
+		set_signal(SIGTERM, on_signal);
+		iExitCode = solve_batch(gpcDefFileName);
+		close_format();
+		return iExitCode;
+	}
 
+	if (read_def(gpcDefFileName) != RET_OK) {
+		close_format();
+		exit(EXIT_ERROR);
+	}
 
-	gcSize = -1;
-	memset(gpstLinkDefs, '\0', sizeof(gpstLinkDefs));
+	init_globals();
+	if (gpcResumeFile != NULL) {
+		if (load_checkpoint(gpcResumeFile) != RET_OK) {
+			exit(EXIT_ERROR);
+		}
+	}
 
-	pstFile = fopen(pcFileName, "r");
-	if (pstFile == NULL) {
-		printf("file open failed. file : %s, errno = %d", pcFileName, errno);
-		return RET_NG;
+	if (gpcTraceFile != NULL) {
+		if (open_trace(gpcTraceFile) != RET_OK) {
+			exit(EXIT_ERROR);
+		}
 	}
 
-	iLineCnt = 0;
-	memset(pcLineBuf, '\0', sizeof(pcLineBuf));
+	set_signal(SIGINT, on_signal);
+	set_signal(SIGTERM, on_signal);
 
-	while (fgets(pcLineBuf, LINE_BUF_LEN + 1, pstFile) != NULL) {
+	if (solve() != RET_OK) {
+		close_trace();
+		close_format();
+		exit(EXIT_ERROR);
+	}
+	close_trace();
+	close_format();
 
-		++iLineCnt;
-		chop(pcLineBuf);
+	if (gpcProfileFile != NULL) {
+		write_profile(gpcProfileFile);
+	}
 
-		if (parse_line(pcLineBuf, pcFileName, iLineCnt) != RET_OK) {
-			fclose(pstFile);
-			return RET_NG;
+	if (gpcOutputFile != NULL) {
+		if (
+			open_bin_writer(&stWriter, gpcOutputFile) != RET_OK
+			|| write_bin(&stWriter, get_bin_result()) != RET_OK
+			|| close_bin_writer(&stWriter) != RET_OK
+		) {
+			printf("%s : write failed.\n", gpcOutputFile);
 		}
 	}
 
-	fclose(pstFile);
-
-	return RET_OK;
+	return get_exit_code();
 }
+#endif
 
-static void chop(
-	char *pcLine
-) {
+static void close_format(void) {
 
-	int iLen = strlen(pcLine);
-	while (--iLen >= 0) {
-		if (!isspace(pcLine[iLen])) {
-			break;
-		}
-		pcLine[iLen] = '\0';
+	if (gcFormat == FORMAT_BINARY && close_bin_writer(&gstFormatWriter) != RET_OK) {
+		printf("solutions can not be written.\n");
 	}
 }
 
-static char parse_line(
-	char *pcLineBuf,
-	const char *pcFileName,
-	int iLineCnt
-) {
+static int get_exit_code(void) {
 
-	static pLINK_DEF pstLinkDef = gpstLinkDefs;
+	switch (gcStopReason) {
+	case STOP_SOLVED:
+		return EXIT_SOLVED;
+	case STOP_NONE:
+		return EXIT_UNSAT;
+	case STOP_CANCEL:
+		return EXIT_CANCEL;
+	default:
+		return EXIT_BUDGET;
+	}
+}
 
-	char *pcLinePtr;
+static char parse_args(
+	int argc,
+	char **argv
+) {
 
-	char *pcMethod;
+	int i;
+
+	gpcDefFileName = NULL;
+	gpcCheckpointFile = NULL;
+	gpcResumeFile = NULL;
+	gpcIncrementalFile = NULL;
+	gpcCacheFile = NULL;
+	giCheckpointInterval = CKPT_INTERVAL;
+	giMaxNodes = 0;
+	gdTimeLimit = 0;
+	giMaxMemory = 0;
+	gpcSocketPath = NULL;
+	giWorkers = SERVER_WORKERS;
+	giJobs = 1;
+	gcRandomize = FLG_OFF;
+	glSeed = 1;
+	gcRestart = RESTART_NONE;
+	giRestartBase = RESTART_BASE;
+	giPortfolio = 1;
+	giDistribute = 1;
+	giSplitDepth = DIST_SPLIT_DEPTH;
+	gcPresolve = FLG_ON;
+	gcSymmetry = FLG_ON;
+	gcNogood = FLG_ON;
+	gcCount = FLG_OFF;
+	gcBatch = FLG_OFF;
+	gpcOutputFile = NULL;
+	gpcConvertFile = NULL;
+	giRecord = 0;
+	gcOrder = ORDER_FIXED;
+	gcFormat = FORMAT_ASCII;
+	gpcTraceFile = NULL;
+	gpcReplayFile = NULL;
+	giReplayAt = -1;
+	gpcProfileFile = NULL;
+	gcAutoTune = FLG_OFF;
+	gcSchedule = FLG_OFF;
+
+	for (i = 1; i < argc; i++) {
+		if (strcmp(argv[i], "--checkpoint") == 0 && i + 1 < argc) {
+			gpcCheckpointFile = argv[++i];
+		} else if (strcmp(argv[i], "--interval") == 0 && i + 1 < argc) {
+			giCheckpointInterval = atoi(argv[++i]);
+			if (giCheckpointInterval <= 0) {
+				printf("%s : interval must be positive.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--resume") == 0 && i + 1 < argc) {
+			gpcResumeFile = argv[++i];
+		} else if (strcmp(argv[i], "--max-nodes") == 0 && i + 1 < argc) {
+			giMaxNodes = atol(argv[++i]);
+			if (giMaxNodes <= 0) {
+				printf("%s : max nodes must be positive.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--time-limit") == 0 && i + 1 < argc) {
+			gdTimeLimit = atof(argv[++i]);
+			if (gdTimeLimit <= 0) {
+				printf("%s : time limit must be positive.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--max-memory") == 0 && i + 1 < argc) {
+			giMaxMemory = atol(argv[++i]);
+			if (giMaxMemory <= 0) {
+				printf("%s : max memory must be positive.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--server") == 0 && i + 1 < argc) {
+			gpcSocketPath = argv[++i];
+		} else if (strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+			giWorkers = atoi(argv[++i]);
+			if (giWorkers <= 0 || giWorkers > MAX_WORKERS) {
+				printf("%s : workers must be between 1 and %d.\n", argv[i], MAX_WORKERS);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--jobs") == 0 && i + 1 < argc) {
+			giJobs = atoi(argv[++i]);
+			if (giJobs <= 0 || giJobs > MAX_JOBS) {
+				printf("%s : jobs must be between 1 and %d.\n", argv[i], MAX_JOBS);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+			glSeed = strtoul(argv[++i], NULL, 10);
+			gcRandomize = FLG_ON;
+		} else if (strcmp(argv[i], "--restart") == 0 && i + 1 < argc) {
+			i++;
+			if (strcmp(argv[i], "luby") == 0) {
+				gcRestart = RESTART_LUBY;
+			} else if (strcmp(argv[i], "geometric") == 0) {
+				gcRestart = RESTART_GEOMETRIC;
+			} else {
+				printf("%s : restart must be luby or geometric.\n", argv[i]);
+				return RET_NG;
+			}
+			gcRandomize = FLG_ON;
+		} else if (strcmp(argv[i], "--restart-base") == 0 && i + 1 < argc) {
+			giRestartBase = atol(argv[++i]);
+			if (giRestartBase <= 0) {
+				printf("%s : restart base must be positive.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--portfolio") == 0 && i + 1 < argc) {
+			giPortfolio = atoi(argv[++i]);
+			if (giPortfolio <= 0 || giPortfolio > MAX_PORTFOLIO) {
+				printf("%s : portfolio must be between 1 and %d.\n", argv[i], MAX_PORTFOLIO);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--distribute") == 0 && i + 1 < argc) {
+			giDistribute = atoi(argv[++i]);
+			if (giDistribute <= 0 || giDistribute > MAX_DIST) {
+				printf("%s : distribute must be between 1 and %d.\n", argv[i], MAX_DIST);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--split-depth") == 0 && i + 1 < argc) {
+			giSplitDepth = atoi(argv[++i]);
+			if (giSplitDepth < 0 || giSplitDepth >= MAX_DEPTH) {
+				printf("%s : split depth must be between 0 and %d.\n", argv[i], MAX_DEPTH - 1);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--order") == 0 && i + 1 < argc) {
+			i++;
+			for (gcOrder = 0; gppcOrderNames[(int) gcOrder] != NULL; gcOrder++) {
+				if (strcmp(argv[i], gppcOrderNames[(int) gcOrder]) == 0) {
+					break;
+				}
+			}
+			if (gppcOrderNames[(int) gcOrder] == NULL) {
+				printf("%s : order must be fixed, partner, wall, exits or history.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--format") == 0 && i + 1 < argc) {
+			i++;
+			for (gcFormat = 0; gppcFormatNames[(int) gcFormat] != NULL; gcFormat++) {
+				if (strcmp(argv[i], gppcFormatNames[(int) gcFormat]) == 0) {
+					break;
+				}
+			}
+			if (gppcFormatNames[(int) gcFormat] == NULL) {
+				printf("%s : format must be ascii, dirs, json or binary.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--no-presolve") == 0) {
+			gcPresolve = FLG_OFF;
+		} else if (strcmp(argv[i], "--incremental") == 0 && i + 1 < argc) {
+			gpcIncrementalFile = argv[++i];
+		} else if (strcmp(argv[i], "--cache") == 0 && i + 1 < argc) {
+			gpcCacheFile = argv[++i];
+		} else if (strcmp(argv[i], "--count") == 0) {
+			gcCount = FLG_ON;
+		} else if (strcmp(argv[i], "--no-symmetry") == 0) {
+			gcSymmetry = FLG_OFF;
+		} else if (strcmp(argv[i], "--no-nogood") == 0) {
+			gcNogood = FLG_OFF;
+		} else if (strcmp(argv[i], "--batch") == 0) {
+			gcBatch = FLG_ON;
+		} else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc) {
+			gpcOutputFile = argv[++i];
+		} else if (strcmp(argv[i], "--convert") == 0 && i + 1 < argc) {
+			gpcConvertFile = argv[++i];
+		} else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+			giRecord = atol(argv[++i]);
+			if (giRecord < 0) {
+				printf("%s : record must not be negative.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+			gpcTraceFile = argv[++i];
+		} else if (strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+			gpcProfileFile = argv[++i];
+		} else if (strcmp(argv[i], "--auto-tune") == 0) {
+			gcAutoTune = FLG_ON;
+		} else if (strcmp(argv[i], "--schedule") == 0) {
+			gcSchedule = FLG_ON;
+		} else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+			gpcReplayFile = argv[++i];
+		} else if (strcmp(argv[i], "--at") == 0 && i + 1 < argc) {
+			giReplayAt = atol(argv[++i]);
+			if (giReplayAt < 0) {
+				printf("%s : record must not be negative.\n", argv[i]);
+				return RET_NG;
+			}
+		} else if (strncmp(argv[i], "--", 2) == 0 || gpcDefFileName != NULL) {
+			return RET_NG;
+		} else {
+			gpcDefFileName = argv[i];
+		}
+	}
 
-	char *pcSize;
-	int iSize;
+	if (gpcDefFileName == NULL && gpcSocketPath == NULL && gpcReplayFile == NULL) {
+		return RET_NG;
+	}
 
-	char *pcLinkName;
-	int iLinkNameLen;
-	pPOINT pstPoint;
+	if (giReplayAt >= 0 && gpcReplayFile == NULL) {
+		printf("--at needs --replay.\n");
+		return RET_NG;
+	}
 
-	char *pcRow;
-	char *pcCol;
-	int iRow;
-	int iCol;
+	// L^͂ЂƂ̃vZX̒T؂ɏ
+	if (
+		gpcTraceFile != NULL
+		&& (giJobs > 1 || giPortfolio > 1 || giDistribute > 1 || gcBatch == FLG_ON || gpcSocketPath != NULL)
+	) {
+		printf("--trace can not be used with --jobs, --portfolio, --distribute, --batch or --server.\n");
+		return RET_NG;
+	}
+
+	// qvZX̏Wv͐eɖ߂Ȃ
+	if (
+		gpcProfileFile != NULL
+		&& (giJobs > 1 || giPortfolio > 1 || giDistribute > 1 || gcBatch == FLG_ON || gpcSocketPath != NULL)
+	) {
+		printf("--profile can not be used with --jobs, --portfolio, --distribute, --batch or --server.\n");
+		return RET_NG;
+	}
 
-	pLINK_DEF pstLinkDefChk;
-	pPOINT pstPointChk;
+	// ͐[Ƃ̏Wvg
+	gcProfile = (gpcProfileFile != NULL || gcAutoTune == FLG_ON) ? FLG_ON : FLG_OFF;
 
-	if (*pcLineBuf == '#') {
-		// Rgs
-		return RET_OK;
+	// ĊJ͓t@CɃ`FbN|Cg
+	if (gpcCheckpointFile == NULL) {
+		gpcCheckpointFile = gpcResumeFile;
 	}
 
-	pcLinePtr = pcLineBuf;
+	// ɉO[v͎菇ɎcȂ̂ōĊJłȂ
+	if (giJobs > 1 && gpcCheckpointFile != NULL) {
+		printf("--jobs can not be used with --checkpoint or --resume.\n");
+		return RET_NG;
+	}
 
-	_consume_space(pcLinePtr);
+	// ͎菇ČłȂ
+	if ((gcRandomize == FLG_ON || giPortfolio > 1) && gpcCheckpointFile != NULL) {
+		printf("--seed, --restart and --portfolio can not be used with --checkpoint or --resume.\n");
+		return RET_NG;
+	}
 
-	if (*pcLinePtr == '\0') {
-		// s
-		return RET_OK;
+	// ɂו͂܂ł̒TŕςA`FbN|CgɎcȂ
+	if (gcOrder == ORDER_HISTORY && gpcCheckpointFile != NULL) {
+		printf("--order history can not be used with --checkpoint or --resume.\n");
+		return RET_NG;
 	}
 
-	pcMethod = pcLinePtr;
+	// C̎sƂɒT蒼̂Ŏ菇ĊJłȂ
+	if (gpcIncrementalFile != NULL && gpcCheckpointFile != NULL) {
+		printf("--incremental can not be used with --checkpoint or --resume.\n");
+		return RET_NG;
+	}
 
-	_get_token(pcLinePtr, ' ');
+	// ؂Ƃɕʂ̃vZXŒT̂ŁAЂƂ̎菇͍ĊJłȂ
+	if (giDistribute > 1 && (gpcCheckpointFile != NULL || gcRestart != RESTART_NONE || giPortfolio > 1)) {
+		printf("--distribute can not be used with --checkpoint, --resume, --restart or --portfolio.\n");
+		return RET_NG;
+	}
 
+	// グ͒T؂xʂ肫Ȃ΂ȂȂ
 	if (
-		strcmp(pcMethod, "size") != 0
-		&& strcmp(pcMethod, "link") != 0
+		gcCount == FLG_ON
+		&& (gpcCheckpointFile != NULL || gcRestart != RESTART_NONE || giPortfolio > 1 || gpcIncrementalFile != NULL)
 	) {
-		_parse_error("%s : 'size' or 'link' required.", pcMethod);
+		printf("--count can not be used with --checkpoint, --resume, --restart, --portfolio or --incremental.\n");
+		return RET_NG;
+	}
+
+	// 育Ƃ̏Ԃ̓t@CЂƂɂѕtȂ
+	if (gcBatch == FLG_ON && (gpcCheckpointFile != NULL || gpcIncrementalFile != NULL || gpcSocketPath != NULL)) {
+		printf("--batch can not be used with --checkpoint, --resume, --incremental or --server.\n");
 		return RET_NG;
 	}
 
-	if (strcmp(pcMethod, "size") == 0) {
+	if (gcFormat == FORMAT_BINARY && (gpcSocketPath != NULL || gpcConvertFile != NULL)) {
+		printf("--format binary can not be used with --server or --convert.\n");
+		return RET_NG;
+	}
 
-		if (*pcLinePtr == '\0') {
-			_parse_error("%s : size required.", pcMethod);
-			return RET_NG;
-		}
+	// @B̌`ł͓ro߂oȂ
+	if (gcFormat != FORMAT_ASCII) {
+		gcQuiet = FLG_ON;
+	}
 
-		pcSize = pcLinePtr;
+	if (gcBatch == FLG_ON && giRecord != 0) {
+		printf("--record can not be used with --batch.\n");
+		return RET_NG;
+	}
 
-		_get_token(pcLinePtr, ' ');
+	if (gpcSocketPath != NULL && (gpcOutputFile != NULL || gpcConvertFile != NULL)) {
+		printf("--output and --convert can not be used with --server.\n");
+		return RET_NG;
+	}
 
-		iSize = atoi(pcSize);
-		if (iSize < MIN_SIZE || iSize > MAX_SIZE) {
-			_parse_error("%s : size must be between %d and %d.", pcSize, MIN_SIZE, MAX_SIZE);
-			return RET_NG;
-		}
+	return RET_OK;
+}
 
-		gcSize = iSize;
+static char read_def(
+	const char* pcFileName
+) {
 
-		if (*pcLinePtr != '\0') {
-			_parse_error("%s : syntax error.", pcLinePtr);
-			return RET_NG;
-		}
+	BIN_FILE stBin;
+	const unsigned char *pbRec;
+	char *pcBuf;
+	long iLen;
+	char cResult;
+	char cRet;
+
+
+	clear_def();
+
+	if (map_def(pcFileName, &pcBuf, &iLen) != RET_OK) {
+		return RET_NG;
 	}
 
-	if (strcmp(pcMethod, "link") == 0) {
+	if (is_bin_def(pcBuf, iLen)) {
 
-		if (gcSize < 0) {
-			_parse_error("size must be specified before link definition.");
-			return RET_NG;
+		// oCi͍w̖肾ǂ
+		cRet = open_bin(&stBin, pcFileName, pcBuf, iLen);
+		if (cRet == RET_OK) {
+			pbRec = seek_bin(&stBin, giRecord);
+			if (pbRec == NULL) {
+				printf("%s : record %ld not found.", pcFileName, giRecord);
+				cRet = RET_NG;
+			} else {
+				cRet = read_bin(&stBin, &pbRec, giRecord, &cResult, NULL);
+			}
 		}
 
-		if ((pstLinkDef - gpstLinkDefs) >= MAX_DEFS) {
-			_parse_error("link definition count exceeded %d.", MAX_DEFS);
-			return RET_NG;
+	} else if (giRecord != 0) {
+		printf("%s : --record needs a binary file.", pcFileName);
+		cRet = RET_NG;
+	} else {
+		cRet = parse_lines(pcBuf, pcBuf + iLen, pcFileName, NULL);
+		if (cRet == RET_OK && gcSize < 0) {
+			printf("%s : size required.", pcFileName);
+			cRet = RET_NG;
 		}
+	}
 
-		// `ȂG[
-		if (*pcLinePtr == '\0') {
-			_parse_error("link definition required.");
-			return RET_NG;
+	unmap_def(pcBuf, iLen);
+
+	return cRet;
+}
+
+static char map_def(
+	const char *pcFileName,
+	char **ppcBuf,
+	long *piLen
+) {
+
+	int iFd;
+	struct stat stStat;
+
+	iFd = open(pcFileName, O_RDONLY);
+	if (iFd < 0 || fstat(iFd, &stStat) != 0) {
+		printf("file open failed. file : %s, errno = %d", pcFileName, errno);
+		if (iFd >= 0) {
+			close(iFd);
 		}
+		return RET_NG;
+	}
+
+	*piLen = stStat.st_size;
+	*ppcBuf = (char *) "";
 
-		// NJnLȂG[
-		if (*pcLinePtr != '\'') {
-			_parse_error("%s : link name must start with '.", pcLinePtr);
+	// ̃t@C͊蓖ĂȂ̂ŁA̍sƂĈ
+	if (*piLen > 0) {
+		*ppcBuf = mmap(NULL, *piLen, PROT_READ, MAP_PRIVATE, iFd, 0);
+		if (*ppcBuf == MAP_FAILED) {
+			printf("file open failed. file : %s, errno = %d", pcFileName, errno);
+			close(iFd);
 			return RET_NG;
 		}
+		madvise(*ppcBuf, *piLen, MADV_SEQUENTIAL);
+	}
 
-		// N̎n[NULL~
-		_consume_delim(pcLinePtr);
+	close(iFd);
 
-		// N̐擪AhX擾
-		pcLinkName = pcLinePtr;
+	return RET_OK;
+}
 
-		_get_number(pcLinePtr);
+static void unmap_def(
+	char *pcBuf,
+	long iLen
+) {
 
-		// N̏ILȂG[
-		if (*pcLinePtr != '\'') {
-			_parse_error("link name must end with '.");
-			return RET_NG;
-		}
+	if (iLen > 0) {
+		munmap(pcBuf, iLen);
+	}
+}
 
-		// N̏I[NULL~
-		_consume_delim(pcLinePtr);
+static int solve_batch(
+	const char *pcFileName
+) {
 
-		// N12oCg
-		iLinkNameLen = strlen(pcLinkName);
-		if (iLinkNameLen < 1 || iLinkNameLen > LINK_NAME_LEN) {
-			_parse_error("%s : link name length must be between 1 and %d.", pcLinkName, LINK_NAME_LEN);
-			return RET_NG;
+	BATCH_STATS stBatch;
+	BIN_WRITER stWriter;
+	BIN_FILE stBin;
+	const unsigned char *pbRec;
+	char *pcBuf;
+	long iLen;
+	long i;
+	char cResult;
+
+	clear_def();
+
+	if (map_def(pcFileName, &pcBuf, &iLen) != RET_OK) {
+		return EXIT_ERROR;
+	}
+
+	memset(&stBatch, '\0', sizeof(BATCH_STATS));
+
+	if (gpcOutputFile != NULL) {
+		if (open_bin_writer(&stWriter, gpcOutputFile) != RET_OK) {
+			unmap_def(pcBuf, iLen);
+			return EXIT_ERROR;
 		}
+		stBatch.pstWriter = &stWriter;
+	}
 
-		for (pstLinkDefChk = gpstLinkDefs; pstLinkDefChk < pstLinkDef; pstLinkDefChk++) {
-			if (atoi(pcLinkName) == atoi(pstLinkDefChk->pcLinkName)) {
-				_parse_error("%s : link name already exists.", pcLinkName);
-				return RET_NG;
+	if (!is_bin_def(pcBuf, iLen)) {
+		parse_lines(pcBuf, pcBuf + iLen, pcFileName, &stBatch);
+	} else if (open_bin(&stBin, pcFileName, pcBuf, iLen) == RET_OK) {
+
+		// oCi͋L^̒ǂĐ擪珇ɓǂ
+		pbRec = stBin.pbBuf + BIN_HEADER_LEN;
+		for (i = 0; i < stBin.iCount && pbRec != NULL && gcCancel == FLG_OFF; i++) {
+			stBatch.iPuzzles++;
+			if (gcFormat == FORMAT_ASCII) {
+				printf("\npuzzle:%d, record:%ld\n", stBatch.iPuzzles, i);
 			}
+			solve_batch_def(&stBatch, read_bin(&stBin, &pbRec, i, &cResult, NULL));
 		}
+	}
 
-		strcpy(pstLinkDef->pcLinkName, pcLinkName);
-		pstPoint = pstLinkDef->pstPoints;
+	unmap_def(pcBuf, iLen);
 
-		do {
+	// 肪 1 Ȃ size ̍sȂ̂Ɠ
+	if (stBatch.iPuzzles == 0 && gcCancel == FLG_OFF) {
+		printf("%s : size required.\n", pcFileName);
+		stBatch.iErrors++;
+		stBatch.iExitCode = EXIT_ERROR;
+	}
 
-			// J}ȂG[
-			if (*pcLinePtr != ',') {
-				_parse_error("%s : missing delimiter.", pcLinePtr);
-				return RET_NG;
-			}
+	if (stBatch.pstWriter != NULL && close_bin_writer(&stWriter) != RET_OK) {
+		printf("%s : write failed.\n", gpcOutputFile);
+	}
 
-			if ((pstPoint - pstLinkDef->pstPoints) >= MAX_POINTS) {
-				_parse_error("link points count exceeded %d.", MAX_POINTS);
-				return RET_NG;
-			}
+	// sƂɓǂތ`ł͖育Ƃ 1 sɂ
+	if (gcFormat != FORMAT_DIRS && gcFormat != FORMAT_JSON) {
+		printf(
+			"\nbatch:%d, solved:%d, unsat:%d, budget:%d, canceled:%d, errors:%d\n",
+			stBatch.iPuzzles,
+			stBatch.iSolved,
+			stBatch.iUnsat,
+			stBatch.iBudget,
+			stBatch.iCanceled,
+			stBatch.iErrors
+		);
+	}
 
-			// J}NULL~
-			_consume_delim(pcLinePtr);
+	return stBatch.iExitCode;
+}
 
-			// |Cg̊JnʂȂG[
-			if (*pcLinePtr != '[') {
-				_parse_error("%s : link point must start with '['.", pcLinePtr);
-				return RET_NG;
-			}
+static void solve_batch_def(
+	pBATCH_STATS pstBatch,
+	char cParsed
+) {
 
-			// |Cg̊JnʂNULL~
-			_consume_delim(pcLinePtr);
+	if (cParsed != RET_OK) {
+		printf("\n");
+		pstBatch->iErrors++;
+		pstBatch->iExitCode = EXIT_ERROR;
+		return;
+	}
 
-			// sԍȂG[
-			if (!isdigit(*pcLinePtr)) {
-				_parse_error("%s : link point(row) required.", pcLinePtr);
-				return RET_NG;
-			}
+	if (pstBatch->cConvert == FLG_ON) {
+		write_bin(pstBatch->pstWriter, BIN_NONE);
+		return;
+	}
 
-			// sԍ̐擪AhX擾
-			pcRow = pcLinePtr;
+	init_globals();
+	if (solve() != RET_OK) {
+		printf("\n");
+		pstBatch->iErrors++;
+		pstBatch->iExitCode = EXIT_ERROR;
+		return;
+	}
 
-			// sԍ̖܂Ń|C^i߂
-			_get_number(pcLinePtr);
+	if (pstBatch->pstWriter != NULL) {
+		write_bin(pstBatch->pstWriter, get_bin_result());
+	}
 
-			// J}ȂG[
-			if (*pcLinePtr != ',') {
-				_parse_error("%s : missing delimiter.", pcLinePtr);
-				return RET_NG;
-			}
+	switch (gcStopReason) {
+	case STOP_SOLVED:
+		pstBatch->iSolved++;
+		break;
+	case STOP_NONE:
+		pstBatch->iUnsat++;
+		break;
+	case STOP_CANCEL:
+		pstBatch->iCanceled++;
+		break;
+	default:
+		pstBatch->iBudget++;
+		break;
+	}
 
-			// J}NULL~
-			_consume_delim(pcLinePtr);
+	// IR[h͈Ԉʂɂ낦
+	if (get_exit_code() > pstBatch->iExitCode) {
+		pstBatch->iExitCode = get_exit_code();
+	}
+}
 
-			// ԍȂG[
-			if (!isdigit(*pcLinePtr)) {
-				_parse_error("%s : link point(column) required.", pcLinePtr);
-				return RET_NG;
-			}
+static char parse_lines(
+	const char *pcBuf,
+	const char *pcBufEnd,
+	const char *pcFileName,
+	pBATCH_STATS pstBatch
+) {
 
-			// ԍ̐擪AhX擾
-			pcCol = pcLinePtr;
+	const char *pcLine;
+	const char *pcLineEnd;
+	const char *pcNext;
+	int iLineCnt;
+	char cParsed;
 
-			// ԍ̖܂Ń|C^i߂
-			_get_number(pcLinePtr);
+	iLineCnt = 0;
+	cParsed = RET_OK;
 
-			// |Cg̏IʂȂG[
-			if (*pcLinePtr != ']') {
-				_parse_error("%s : link point must end with ']'.", pcLinePtr);
-				return RET_NG;
-			}
+	for (pcLine = pcBuf; pcLine < pcBufEnd; pcLine = pcNext) {
 
-			// |Cg̏IʂNULL~
-			_consume_delim(pcLinePtr);
+		pcLineEnd = memchr(pcLine, '\n', pcBufEnd - pcLine);
+		if (pcLineEnd == NULL) {
+			pcLineEnd = pcBufEnd;
+			pcNext = pcBufEnd;
+		} else {
+			pcNext = pcLineEnd + 1;
+		}
 
-			iRow = atoi(pcRow);
-			if (iRow < 0 || iRow >= gcSize) {
-				_parse_error("%s : row number must be between 0 and %d.", pcRow, gcSize - 1);
-				return RET_NG;
-			}
-			pstPoint->cRow = iRow;
+		++iLineCnt;
 
-			iCol = atoi(pcCol);
-			if (iCol < 0 || iCol >= gcSize) {
-				_parse_error("%s : column number must be between 0 and %d.", pcCol, gcSize - 1);
-				return RET_NG;
-			}
-			pstPoint->cCol = iCol;
+		while (pcLineEnd > pcLine && isspace(pcLineEnd[-1])) {
+			pcLineEnd--;
+		}
 
-			for (pstLinkDefChk = gpstLinkDefs; pstLinkDefChk <= pstLinkDef; pstLinkDefChk++) {
-				for (pstPointChk = pstLinkDefChk->pstPoints; HAS_POINT(pstPointChk) && pstPointChk < pstPoint; pstPointChk++) {
-					if (memcmp(pstPoint, pstPointChk, sizeof(POINT)) == 0) {
-						_parse_error("point [%d,%d] already exists.", iRow, iCol);
-						return RET_NG;
-					}
+		// ܂Ƃ߂ĉƂ 'size' ̍sŎ̖Ɉڂ
+		// ŏ 'size' ̍sOɒ`΁Asize ̂ȂƂĐ
+		if (
+			pstBatch != NULL
+			&& (is_size_line(pcLine, pcLineEnd) || (pstBatch->iLineCnt == 0 && !is_blank_line(pcLine, pcLineEnd)))
+		) {
+			if (pstBatch->iLineCnt > 0) {
+				solve_batch_def(pstBatch, cParsed);
+				if (gcCancel == FLG_ON) {
+					return RET_OK;
 				}
 			}
-			pstPoint++;
-
-		} while (*pcLinePtr != '\0');
-
-		if ((pstPoint - pstLinkDef->pstPoints) < MIN_POINTS) {
-			_parse_error("link definition must have at least %d points.", MIN_POINTS);
-			return RET_NG;
+			clear_def();
+			cParsed = RET_OK;
+			pstBatch->iLineCnt = iLineCnt;
+			pstBatch->iPuzzles++;
+			if (pstBatch->cConvert == FLG_OFF && gcFormat == FORMAT_ASCII) {
+				printf("\npuzzle:%d, line:%d\n", pstBatch->iPuzzles, iLineCnt);
+			}
 		}
 
-		pstPoint->cRow = -1;
-		pstPoint->cCol = -1;
-		pstLinkDef++;
+		if (cParsed == RET_OK) {
+			cParsed = parse_line(pcLine, pcLineEnd, pcFileName, iLineCnt);
+			if (cParsed != RET_OK && pstBatch == NULL) {
+				return RET_NG;
+			}
+		}
+	}
 
+	if (pstBatch != NULL && pstBatch->iLineCnt > 0) {
+		solve_batch_def(pstBatch, cParsed);
 	}
 
 	return RET_OK;
 }
 
-static void init_globals() {
+static char is_size_line(
+	const char *pcLine,
+	const char *pcLineEnd
+) {
+
+	_skip_space(pcLine, pcLineEnd);
+
+	return (
+		pcLineEnd - pcLine >= 4
+		&& memcmp(pcLine, "size", 4) == 0
+		&& (pcLineEnd - pcLine == 4 || isspace(pcLine[4]))
+	);
+}
 
-	int *piSplitPattern;
+static char is_blank_line(
+	const char *pcLine,
+	const char *pcLineEnd
+) {
 
-	memset(gpcSplitPatternTbl, '\0', sizeof(gpcSplitPatternTbl));
-	for (piSplitPattern =gpiSplitPatterns; *piSplitPattern >= 0; piSplitPattern++) {
-		gpcSplitPatternTbl[*piSplitPattern] = FLG_ON;
+	if (pcLine < pcLineEnd && *pcLine == '#') {
+		return 1;
 	}
 
-	memset(gppcZeroExitPoints, '\0', sizeof(gppcZeroExitPoints));
+	_skip_space(pcLine, pcLineEnd);
 
-	time(&gtStartTime);
-	giOkCases = 0;
-	giBranchErrCases = 0;
-	giDeadEndCases = 0;
-	giDeadPartitionCases = 0;
-	giSplitLinkCases = 0;
-	giFd1DeadPartitionCases = 0;
-	giMultiSplitCases = 0;
+	return pcLine == pcLineEnd;
+}
 
+static void clear_def(void) {
+	gcSize = -1;
+	memset(gpstLinkDefs, '\0', sizeof(gpstLinkDefs));
+	memset(gpstPathDefs, '\0', sizeof(gpstPathDefs));
+	memset(gpcDefIds, '\0', sizeof(gpcDefIds));
+	memset(gpcDefCells, '\0', sizeof(gpcDefCells));
+	gcDefCnt = 0;
+	gcPathCnt = 0;
 }
 
-static char init_status(
-	pSTATUS pstStatus
+static void chop(
+	char *pcLine
 ) {
 
-	pLINK_DEF pstLinkDef;
-	pLINK_PART pstLinkPart;
-	pLINK_PART pstPrevLink;
-	pPOINT pstFrom;
-	pPOINT pstTo;
-
-	char cRow;
-	char cCol;
-
+	int iLen = strlen(pcLine);
+	while (--iLen >= 0) {
+		if (!isspace(pcLine[iLen])) {
+			break;
+		}
+		pcLine[iLen] = '\0';
+	}
+}
+
+static char parse_line(
+	const char *pcLinePtr,
+	const char *pcLineEnd,
+	const char *pcFileName,
+	int iLineCnt
+) {
+
+	pLINK_DEF pstLinkDef;
+
+	const char *pcMethod;
+	int iMethodLen;
+
+	const char *pcSize;
+	int iSizeLen;
+	int iSize;
+
+	const char *pcLinkName;
+	int iLinkNameLen;
+	int iLinkId;
+	pPOINT pstPoint;
+
+	int iCell;
+
+	pPATH_DEF pstPathDef;
+
+	if (pcLinePtr < pcLineEnd && *pcLinePtr == '#') {
+		// Rgs
+		return RET_OK;
+	}
+
+	_skip_space(pcLinePtr, pcLineEnd);
+
+	if (pcLinePtr == pcLineEnd) {
+		// s
+		return RET_OK;
+	}
+
+	pcMethod = pcLinePtr;
+
+	_skip_token(pcLinePtr, pcLineEnd);
+	iMethodLen = pcLinePtr - pcMethod;
+	_skip_space(pcLinePtr, pcLineEnd);
+
+	if (
+		!_is_token(pcMethod, iMethodLen, "size")
+		&& !_is_token(pcMethod, iMethodLen, "link")
+		&& !_is_token(pcMethod, iMethodLen, "path")
+	) {
+		_parse_error("%.*s : 'size', 'link' or 'path' required.", iMethodLen, pcMethod);
+		return RET_NG;
+	}
+
+	if (_is_token(pcMethod, iMethodLen, "size")) {
+
+		if (pcLinePtr == pcLineEnd) {
+			_parse_error("%.*s : size required.", iMethodLen, pcMethod);
+			return RET_NG;
+		}
+
+		pcSize = pcLinePtr;
+
+		_skip_token(pcLinePtr, pcLineEnd);
+		iSizeLen = pcLinePtr - pcSize;
+		_skip_space(pcLinePtr, pcLineEnd);
+
+		iSize = parse_int(pcSize, pcSize + iSizeLen);
+		if (iSize < MIN_SIZE || iSize > MAX_SIZE) {
+			_parse_error("%.*s : size must be between %d and %d.", iSizeLen, pcSize, MIN_SIZE, MAX_SIZE);
+			return RET_NG;
+		}
+
+		gcSize = iSize;
+
+		if (pcLinePtr != pcLineEnd) {
+			_parse_error("%.*s : syntax error.", _rest(pcLinePtr, pcLineEnd));
+			return RET_NG;
+		}
+	}
+
+	if (_is_token(pcMethod, iMethodLen, "link")) {
+
+		if (gcSize < 0) {
+			_parse_error("size must be specified before link definition.");
+			return RET_NG;
+		}
+
+		if (gcDefCnt >= MAX_DEFS) {
+			_parse_error("link definition count exceeded %d.", MAX_DEFS);
+			return RET_NG;
+		}
+		pstLinkDef = gpstLinkDefs + gcDefCnt;
+
+		if (parse_link_name(&pcLinePtr, pcLineEnd, &pcLinkName, &iLinkNameLen, pcFileName, iLineCnt) != RET_OK) {
+			return RET_NG;
+		}
+
+		// N͐ 2 ܂łȂ̂ŁAO̒lň
+		iLinkId = parse_int(pcLinkName, pcLinkName + iLinkNameLen);
+		if (gpcDefIds[iLinkId] != 0) {
+			_parse_error("%.*s : link name already exists.", iLinkNameLen, pcLinkName);
+			return RET_NG;
+		}
+
+		memcpy(pstLinkDef->pcLinkName, pcLinkName, iLinkNameLen);
+		pstLinkDef->pcLinkName[iLinkNameLen] = '\0';
+		pstPoint = pstLinkDef->pstPoints;
+
+		do {
+
+			// J}ȂG[
+			if (pcLinePtr == pcLineEnd || *pcLinePtr != ',') {
+				_parse_error("%.*s : missing delimiter.", _rest(pcLinePtr, pcLineEnd));
+				return RET_NG;
+			}
+
+			if ((pstPoint - pstLinkDef->pstPoints) >= MAX_POINTS) {
+				_parse_error("link points count exceeded %d.", MAX_POINTS);
+				return RET_NG;
+			}
+
+			// J}ǂݔ΂
+			_skip_delim(pcLinePtr, pcLineEnd);
+
+			if (parse_point(&pcLinePtr, pcLineEnd, pstPoint, pcFileName, iLineCnt) != RET_OK) {
+				return RET_NG;
+			}
+
+			// g}X̓rbgŊoĂ
+			iCell = pstPoint->cRow * MAX_SIZE + pstPoint->cCol;
+			if ((gpcDefCells[iCell / 8] & (1 << (iCell % 8))) != 0) {
+				_parse_error("point [%d,%d] already exists.", pstPoint->cRow, pstPoint->cCol);
+				return RET_NG;
+			}
+			gpcDefCells[iCell / 8] |= (1 << (iCell % 8));
+			pstPoint++;
+
+		} while (pcLinePtr != pcLineEnd);
+
+		if ((pstPoint - pstLinkDef->pstPoints) < MIN_POINTS) {
+			_parse_error("link definition must have at least %d points.", MIN_POINTS);
+			return RET_NG;
+		}
+
+		pstPoint->cRow = -1;
+		pstPoint->cCol = -1;
+		gpcDefIds[iLinkId] = ++gcDefCnt;
+
+	}
+
+	// ĂoH (N̒[_珇ɂǂ}X)
+	if (_is_token(pcMethod, iMethodLen, "path")) {
+
+		if (gcPathCnt >= MAX_PATHS) {
+			_parse_error("path definition count exceeded %d.", MAX_PATHS);
+			return RET_NG;
+		}
+		pstPathDef = gpstPathDefs + gcPathCnt;
+
+		if (pcLinePtr == pcLineEnd) {
+			_parse_error("path definition required.");
+			return RET_NG;
+		}
+
+		if (parse_link_name(&pcLinePtr, pcLineEnd, &pcLinkName, &iLinkNameLen, pcFileName, iLineCnt) != RET_OK) {
+			return RET_NG;
+		}
+
+		iLinkId = parse_int(pcLinkName, pcLinkName + iLinkNameLen);
+		if (gpcDefIds[iLinkId] == 0) {
+			_parse_error("%.*s : link must be defined before its path.", iLinkNameLen, pcLinkName);
+			return RET_NG;
+		}
+
+		strcpy(pstPathDef->pcLinkName, gpstLinkDefs[gpcDefIds[iLinkId] - 1].pcLinkName);
+		pstPoint = pstPathDef->pstPoints;
+
+		do {
+
+			if (pcLinePtr == pcLineEnd || *pcLinePtr != ',') {
+				_parse_error("%.*s : missing delimiter.", _rest(pcLinePtr, pcLineEnd));
+				return RET_NG;
+			}
+
+			if ((pstPoint - pstPathDef->pstPoints) >= MAX_PATH_POINTS) {
+				_parse_error("path points count exceeded %d.", MAX_PATH_POINTS);
+				return RET_NG;
+			}
+
+			_skip_delim(pcLinePtr, pcLineEnd);
+
+			if (parse_point(&pcLinePtr, pcLineEnd, pstPoint, pcFileName, iLineCnt) != RET_OK) {
+				return RET_NG;
+			}
+			pstPoint++;
+
+		} while (pcLinePtr != pcLineEnd);
+
+		if ((pstPoint - pstPathDef->pstPoints) < MIN_POINTS) {
+			_parse_error("path definition must have at least %d points.", MIN_POINTS);
+			return RET_NG;
+		}
+
+		pstPoint->cRow = -1;
+		pstPoint->cCol = -1;
+		gcPathCnt++;
+	}
+
+	return RET_OK;
+}
+
+static char parse_link_name(
+	const char **ppcLinePtr,
+	const char *pcLineEnd,
+	const char **ppcLinkName,
+	int *piLinkNameLen,
+	const char *pcFileName,
+	int iLineCnt
+) {
+
+	const char *pcLinePtr = *ppcLinePtr;
+	const char *pcLinkName;
+	int iLinkNameLen;
+
+	// `ȂG[
+	if (pcLinePtr == pcLineEnd) {
+		_parse_error("link definition required.");
+		return RET_NG;
+	}
+
+	// NJnLȂG[
+	if (*pcLinePtr != '\'') {
+		_parse_error("%.*s : link name must start with '.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// N̎n[ǂݔ΂
+	_skip_delim(pcLinePtr, pcLineEnd);
+
+	// N̐擪AhX擾
+	pcLinkName = pcLinePtr;
+
+	_skip_number(pcLinePtr, pcLineEnd);
+	iLinkNameLen = pcLinePtr - pcLinkName;
+	_skip_space(pcLinePtr, pcLineEnd);
+
+	// N̏ILȂG[
+	if (pcLinePtr == pcLineEnd || *pcLinePtr != '\'') {
+		_parse_error("link name must end with '.");
+		return RET_NG;
+	}
+
+	// N̏I[ǂݔ΂
+	_skip_delim(pcLinePtr, pcLineEnd);
+
+	// N12oCg
+	if (iLinkNameLen < 1 || iLinkNameLen > LINK_NAME_LEN) {
+		_parse_error("%.*s : link name length must be between 1 and %d.", iLinkNameLen, pcLinkName, LINK_NAME_LEN);
+		return RET_NG;
+	}
+
+	*ppcLinkName = pcLinkName;
+	*piLinkNameLen = iLinkNameLen;
+	*ppcLinePtr = pcLinePtr;
+
+	return RET_OK;
+}
+
+static char parse_point(
+	const char **ppcLinePtr,
+	const char *pcLineEnd,
+	pPOINT pstPoint,
+	const char *pcFileName,
+	int iLineCnt
+) {
+
+	const char *pcLinePtr = *ppcLinePtr;
+	const char *pcRow;
+	const char *pcCol;
+	int iRowLen;
+	int iColLen;
+	int iRow;
+	int iCol;
+
+	// |Cg̊JnʂȂG[
+	if (pcLinePtr == pcLineEnd || *pcLinePtr != '[') {
+		_parse_error("%.*s : link point must start with '['.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// |Cg̊Jnʂǂݔ΂
+	_skip_delim(pcLinePtr, pcLineEnd);
+
+	// sԍȂG[
+	if (pcLinePtr == pcLineEnd || !isdigit(*pcLinePtr)) {
+		_parse_error("%.*s : link point(row) required.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// sԍ̐擪AhX擾
+	pcRow = pcLinePtr;
+
+	// sԍ̖܂Ń|C^i߂
+	_skip_number(pcLinePtr, pcLineEnd);
+	iRowLen = pcLinePtr - pcRow;
+	_skip_space(pcLinePtr, pcLineEnd);
+
+	// J}ȂG[
+	if (pcLinePtr == pcLineEnd || *pcLinePtr != ',') {
+		_parse_error("%.*s : missing delimiter.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// J}ǂݔ΂
+	_skip_delim(pcLinePtr, pcLineEnd);
+
+	// ԍȂG[
+	if (pcLinePtr == pcLineEnd || !isdigit(*pcLinePtr)) {
+		_parse_error("%.*s : link point(column) required.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// ԍ̐擪AhX擾
+	pcCol = pcLinePtr;
+
+	// ԍ̖܂Ń|C^i߂
+	_skip_number(pcLinePtr, pcLineEnd);
+	iColLen = pcLinePtr - pcCol;
+	_skip_space(pcLinePtr, pcLineEnd);
+
+	// |Cg̏IʂȂG[
+	if (pcLinePtr == pcLineEnd || *pcLinePtr != ']') {
+		_parse_error("%.*s : link point must end with ']'.", _rest(pcLinePtr, pcLineEnd));
+		return RET_NG;
+	}
+
+	// |Cg̏Iʂǂݔ΂
+	_skip_delim(pcLinePtr, pcLineEnd);
+
+	iRow = parse_int(pcRow, pcRow + iRowLen);
+	if (iRow < 0 || iRow >= gcSize) {
+		_parse_error("%.*s : row number must be between 0 and %d.", iRowLen, pcRow, gcSize - 1);
+		return RET_NG;
+	}
+	pstPoint->cRow = iRow;
+
+	iCol = parse_int(pcCol, pcCol + iColLen);
+	if (iCol < 0 || iCol >= gcSize) {
+		_parse_error("%.*s : column number must be between 0 and %d.", iColLen, pcCol, gcSize - 1);
+		return RET_NG;
+	}
+	pstPoint->cCol = iCol;
+
+	*ppcLinePtr = pcLinePtr;
+
+	return RET_OK;
+}
+
+static int parse_int(
+	const char *pcPtr,
+	const char *pcEnd
+) {
+
+	int iSign;
+	int iValue;
+
+	// atoi Ɠ擪̕Ɛǂ (傫l͓ł)
+	iSign = 1;
+	if (pcPtr < pcEnd && (*pcPtr == '+' || *pcPtr == '-')) {
+		if (*pcPtr == '-') {
+			iSign = -1;
+		}
+		pcPtr++;
+	}
+
+	iValue = 0;
+	while (pcPtr < pcEnd && isdigit(*pcPtr)) {
+		if (iValue < INT_MAX / 10) {
+			iValue = iValue * 10 + (*pcPtr - '0');
+		}
+		pcPtr++;
+	}
+
+	return iSign * iValue;
+}
+
+static char is_bin_def(
+	const char *pcBuf,
+	long iLen
+) {
+
+	return (iLen >= BIN_HEADER_LEN && memcmp(pcBuf, BIN_MAGIC, 4) == 0);
+}
+
+static char open_bin(
+	pBIN_FILE pstBin,
+	const char *pcFileName,
+	const char *pcBuf,
+	long iLen
+) {
+
+	const unsigned char *pbBuf = (const unsigned char *) pcBuf;
+	unsigned long lIndex;
+
+	pstBin->pcFileName = pcFileName;
+	pstBin->pbBuf = pbBuf;
+	pstBin->iLen = iLen;
+
+	if (pbBuf[4] != BIN_VERSION) {
+		printf("%s : binary version %d is not supported.\n", pcFileName, pbBuf[4]);
+		return RET_NG;
+	}
+
+	if (iLen < BIN_HEADER_LEN + BIN_FOOTER_LEN) {
+		printf("%s : broken binary file.\n", pcFileName);
+		return RET_NG;
+	}
+
+	// ɍ̈ʒuƌ
+	lIndex = get_le(pbBuf + iLen - BIN_FOOTER_LEN, 8);
+	pstBin->iCount = get_le(pbBuf + iLen - BIN_FOOTER_LEN + 8, 8);
+	pstBin->pbIndex = pbBuf + lIndex;
+
+	if (
+		lIndex < BIN_HEADER_LEN
+		|| lIndex + ((pstBin->iCount + BIN_INDEX_STEP - 1) / BIN_INDEX_STEP) * 8 != (unsigned long) (iLen - BIN_FOOTER_LEN)
+	) {
+		printf("%s : broken binary file.\n", pcFileName);
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static const unsigned char *seek_bin(
+	pBIN_FILE pstBin,
+	long iRecord
+) {
+
+	const unsigned char *pbRec;
+	unsigned long lOffset;
+	long i;
+
+	if (iRecord < 0 || iRecord >= pstBin->iCount) {
+		return NULL;
+	}
+
+	lOffset = get_le(pstBin->pbIndex + (iRecord / BIN_INDEX_STEP) * 8, 8);
+	if (lOffset < BIN_HEADER_LEN || lOffset >= (unsigned long) (pstBin->pbIndex - pstBin->pbBuf)) {
+		return NULL;
+	}
+
+	//  BIN_INDEX_STEP Ȃ̂ŁAc͒ǂĐi
+	pbRec = pstBin->pbBuf + lOffset;
+	for (i = iRecord - iRecord % BIN_INDEX_STEP; i < iRecord; i++) {
+		if (pbRec + 2 > pstBin->pbIndex) {
+			return NULL;
+		}
+		pbRec += 2 + get_le(pbRec, 2);
+	}
+
+	if (pbRec + 2 > pstBin->pbIndex) {
+		return NULL;
+	}
+
+	return pbRec;
+}
+
+static char read_bin(
+	pBIN_FILE pstBin,
+	const unsigned char **ppbRec,
+	long iRecord,
+	char *pcResult,
+	pPATH_DEF pstSolution
+) {
+
+	const unsigned char *pbPtr;
+	const unsigned char *pbEnd;
+	pLINK_DEF pstLinkDef;
+	pPATH_DEF pstPathDef;
+	pPOINT pstPoint;
+	pPOINT pstLast;
+	POINT stNext;
+	char cLinkCnt;
+	char cPathCnt;
+	int iPointCnt;
+	int iLinkId;
+	int iCell;
+	int iCode;
+	int i;
+	int j;
+
+	clear_def();
+
+	// Ăւ͐i߂Ȃ
+	pbPtr = *ppbRec;
+	*ppbRec = NULL;
+	if (pbPtr + 2 > pstBin->pbIndex || get_le(pbPtr, 2) == 0 || pbPtr + 2 + get_le(pbPtr, 2) > pstBin->pbIndex) {
+		_bin_error("broken record.");
+		return RET_NG;
+	}
+	pbEnd = pbPtr + 2 + get_le(pbPtr, 2);
+	*ppbRec = pbEnd;
+	pbPtr += 2;
+
+	if (pbEnd - pbPtr < 4) {
+		_bin_error("broken record.");
+		return RET_NG;
+	}
+
+	gcSize = *(pbPtr++);
+	*pcResult = *(pbPtr++);
+	cLinkCnt = *(pbPtr++);
+	cPathCnt = *(pbPtr++);
+
+	if (gcSize < MIN_SIZE || gcSize > MAX_SIZE || cLinkCnt > MAX_DEFS || cPathCnt > MAX_PATHS) {
+		_bin_error("broken record.");
+		return RET_NG;
+	}
+
+	// N͖OA_̐A_ ( 4 rbgsA 4 rbg) ̏
+	for (pstLinkDef = gpstLinkDefs; pstLinkDef < gpstLinkDefs + cLinkCnt; pstLinkDef++) {
+
+		if (pbEnd - pbPtr < 2) {
+			_bin_error("broken record.");
+			return RET_NG;
+		}
+
+		iLinkId = *pbPtr & BIN_NAME_MASK;
+		sprintf(pstLinkDef->pcLinkName, (*pbPtr & BIN_NAME_ZERO) != 0 ? "0%d" : "%d", iLinkId);
+		iPointCnt = pbPtr[1];
+		pbPtr += 2;
+
+		if (
+			iLinkId >= LINK_ID_CNT || gpcDefIds[iLinkId] != 0
+			|| iPointCnt < MIN_POINTS || iPointCnt > MAX_POINTS || pbEnd - pbPtr < iPointCnt
+		) {
+			_bin_error("broken record.");
+			return RET_NG;
+		}
+		gpcDefIds[iLinkId] = ++gcDefCnt;
+
+		for (pstPoint = pstLinkDef->pstPoints; pstPoint < pstLinkDef->pstPoints + iPointCnt; pstPoint++, pbPtr++) {
+			pstPoint->cRow = *pbPtr >> 4;
+			pstPoint->cCol = *pbPtr & 0x0f;
+			iCell = pstPoint->cRow * MAX_SIZE + pstPoint->cCol;
+			if (
+				pstPoint->cRow >= gcSize || pstPoint->cCol >= gcSize
+				|| (gpcDefCells[iCell / 8] & (1 << (iCell % 8))) != 0
+			) {
+				_bin_error("broken record.");
+				return RET_NG;
+			}
+			gpcDefCells[iCell / 8] |= (1 << (iCell % 8));
+		}
+		pstPoint->cRow = -1;
+		pstPoint->cCol = -1;
+	}
+
+	// ĂoH̓N̔ԍA_̐A_̏
+	for (pstPathDef = gpstPathDefs; pstPathDef < gpstPathDefs + cPathCnt; pstPathDef++) {
+
+		if (pbEnd - pbPtr < 2 || pbPtr[0] >= cLinkCnt) {
+			_bin_error("broken record.");
+			return RET_NG;
+		}
+
+		strcpy(pstPathDef->pcLinkName, gpstLinkDefs[pbPtr[0]].pcLinkName);
+		iPointCnt = pbPtr[1];
+		pbPtr += 2;
+
+		if (iPointCnt < MIN_POINTS || iPointCnt > MAX_PATH_POINTS || pbEnd - pbPtr < iPointCnt) {
+			_bin_error("broken record.");
+			return RET_NG;
+		}
+
+		for (pstPoint = pstPathDef->pstPoints; pstPoint < pstPathDef->pstPoints + iPointCnt; pstPoint++, pbPtr++) {
+			pstPoint->cRow = *pbPtr >> 4;
+			pstPoint->cCol = *pbPtr & 0x0f;
+			if (pstPoint->cRow >= gcSize || pstPoint->cCol >= gcSize) {
+				_bin_error("broken record.");
+				return RET_NG;
+			}
+		}
+		pstPoint->cRow = -1;
+		pstPoint->cCol = -1;
+		gcPathCnt++;
+	}
+
+	if (pbEnd - pbPtr != ((*pcResult == BIN_SOLVED) ? BIN_CODE_LEN(gcSize) : 0)) {
+		_bin_error("broken record.");
+		return RET_NG;
+	}
+
+	if (*pcResult != BIN_SOLVED) {
+		return RET_OK;
+	}
+
+	if (pstSolution == NULL) {
+		return RET_OK;
+	}
+
+	// ̓}XƂ̎̃}Xւ̌ (2 rbg) n_炽ǂ
+	memset(pstSolution, '\0', sizeof(PATH_DEF) * (MAX_DEFS + 1));
+	for (i = 0; i < cLinkCnt; i++) {
+
+		pstLinkDef = gpstLinkDefs + i;
+		pstPathDef = pstSolution + i;
+		for (pstLast = pstLinkDef->pstPoints; HAS_POINT((pstLast + 1)); pstLast++);
+
+		strcpy(pstPathDef->pcLinkName, pstLinkDef->pcLinkName);
+		j = 0;
+		pstPathDef->pstPoints[j] = pstLinkDef->pstPoints[0];
+		while (memcmp(pstPathDef->pstPoints + j, pstLast, sizeof(POINT)) != 0) {
+
+			iCell = pstPathDef->pstPoints[j].cRow * gcSize + pstPathDef->pstPoints[j].cCol;
+			iCode = (pbPtr[iCell / 4] >> ((iCell % 4) * 2)) & 0x03;
+			stNext.cRow = pstPathDef->pstPoints[j].cRow + gpstDirections[iCode].cRowDelta;
+			stNext.cCol = pstPathDef->pstPoints[j].cCol + gpstDirections[iCode].cColDelta;
+
+			if (
+				j >= MAX_PATH_POINTS - 1
+				|| stNext.cRow < 0 || stNext.cRow >= gcSize
+				|| stNext.cCol < 0 || stNext.cCol >= gcSize
+			) {
+				_bin_error("broken solution.");
+				return RET_NG;
+			}
+
+			pstPathDef->pstPoints[++j] = stNext;
+		}
+		pstPathDef->pstPoints[++j].cRow = -1;
+		pstPathDef->pstPoints[j].cCol = -1;
+	}
+
+	return RET_OK;
+}
+
+static char open_bin_writer(
+	pBIN_WRITER pstWriter,
+	const char *pcFileName
+) {
+
+
+	FILE *pstFile;
+
+	pstFile = fopen(pcFileName, "wb");
+	if (pstFile == NULL) {
+		printf("file open failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	init_bin_writer(pstWriter, pstFile);
+
+	return RET_OK;
+}
+
+static void init_bin_writer(
+	pBIN_WRITER pstWriter,
+	FILE *pstFile
+) {
+
+	unsigned char pbHeader[BIN_HEADER_LEN];
+
+	memset(pstWriter, '\0', sizeof(BIN_WRITER));
+	pstWriter->pstFile = pstFile;
+
+	memset(pbHeader, '\0', sizeof(pbHeader));
+	memcpy(pbHeader, BIN_MAGIC, 4);
+	pbHeader[4] = BIN_VERSION;
+	fwrite(pbHeader, sizeof(pbHeader), 1, pstWriter->pstFile);
+	pstWriter->lOffset = BIN_HEADER_LEN;
+}
+
+static char write_bin(
+	pBIN_WRITER pstWriter,
+	char cResult
+) {
+
+	unsigned char pbRec[BIN_RECORD_LEN];
+	unsigned char *pbPtr;
+	unsigned char *pbCodes;
+	pLINK_DEF pstLinkDef;
+	pPATH_DEF pstPathDef;
+	PATH_DEF stPathDef;
+	pPOINT pstPoint;
+	int iLinkId;
+	int iCell;
+	char cDir;
+	int i;
+
+	pbPtr = pbRec + 2;
+	*(pbPtr++) = gcSize;
+	*(pbPtr++) = cResult;
+	*(pbPtr++) = gcDefCnt;
+	*(pbPtr++) = gcPathCnt;
+
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+		iLinkId = atoi(pstLinkDef->pcLinkName);
+		*(pbPtr++) = iLinkId | ((pstLinkDef->pcLinkName[0] == '0' && pstLinkDef->pcLinkName[1] != '\0') ? BIN_NAME_ZERO : 0);
+		for (i = 0; HAS_POINT((pstLinkDef->pstPoints + i)); i++);
+		*(pbPtr++) = i;
+		for (pstPoint = pstLinkDef->pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			*(pbPtr++) = (pstPoint->cRow << 4) | pstPoint->cCol;
+		}
+	}
+
+	for (pstPathDef = gpstPathDefs; pstPathDef < gpstPathDefs + gcPathCnt; pstPathDef++) {
+		*(pbPtr++) = gpcDefIds[atoi(pstPathDef->pcLinkName)] - 1;
+		for (i = 0; HAS_POINT((pstPathDef->pstPoints + i)); i++);
+		*(pbPtr++) = i;
+		for (pstPoint = pstPathDef->pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			*(pbPtr++) = (pstPoint->cRow << 4) | pstPoint->cCol;
+		}
+	}
+
+	if (cResult == BIN_SOLVED) {
+
+		pbCodes = pbPtr;
+		memset(pbCodes, '\0', BIN_CODE_LEN(gcSize));
+		pbPtr += BIN_CODE_LEN(gcSize);
+
+		for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+
+			if (get_solution_path(&gstSolution, pstLinkDef, &stPathDef) != RET_OK) {
+				return RET_NG;
+			}
+
+			for (pstPoint = stPathDef.pstPoints; HAS_POINT((pstPoint + 1)); pstPoint++) {
+				for (cDir = 0; cDir < NEIGHBOR_CNT; cDir++) {
+					if (
+						pstPoint->cRow + gpstDirections[(int) cDir].cRowDelta == pstPoint[1].cRow
+						&& pstPoint->cCol + gpstDirections[(int) cDir].cColDelta == pstPoint[1].cCol
+					) {
+						break;
+					}
+				}
+				iCell = pstPoint->cRow * gcSize + pstPoint->cCol;
+				pbCodes[iCell / 4] |= cDir << ((iCell % 4) * 2);
+			}
+		}
+	}
+
+	set_le(pbRec, pbPtr - pbRec - 2, 2);
+
+	// ɂ BIN_INDEX_STEP Ƃ̐擪c
+	if (pstWriter->iCount % BIN_INDEX_STEP == 0) {
+		if (pstWriter->iCount / BIN_INDEX_STEP >= pstWriter->iIndexCap) {
+			pstWriter->iIndexCap = (pstWriter->iIndexCap == 0) ? 1024 : pstWriter->iIndexCap * 2;
+			pstWriter->plIndex = realloc(pstWriter->plIndex, sizeof(unsigned long) * pstWriter->iIndexCap);
+		}
+		pstWriter->plIndex[pstWriter->iCount / BIN_INDEX_STEP] = pstWriter->lOffset;
+	}
+
+	fwrite(pbRec, pbPtr - pbRec, 1, pstWriter->pstFile);
+	pstWriter->lOffset += pbPtr - pbRec;
+	pstWriter->iCount++;
+
+	return RET_OK;
+}
+
+static char close_bin_writer(
+	pBIN_WRITER pstWriter
+) {
+
+	unsigned char pbBuf[BIN_FOOTER_LEN];
+	long i;
+	char cRet;
+
+	//  0 ̋L^ŏɓǂޑɏIm点
+	memset(pbBuf, '\0', sizeof(pbBuf));
+	fwrite(pbBuf, 2, 1, pstWriter->pstFile);
+	pstWriter->lOffset += 2;
+
+	for (i = 0; i < (pstWriter->iCount + BIN_INDEX_STEP - 1) / BIN_INDEX_STEP; i++) {
+		set_le(pbBuf, pstWriter->plIndex[i], 8);
+		fwrite(pbBuf, 8, 1, pstWriter->pstFile);
+	}
+
+	set_le(pbBuf, pstWriter->lOffset, 8);
+	set_le(pbBuf + 8, pstWriter->iCount, 8);
+	fwrite(pbBuf, BIN_FOOTER_LEN, 1, pstWriter->pstFile);
+
+	cRet = (ferror(pstWriter->pstFile) == 0) ? RET_OK : RET_NG;
+	if (fclose(pstWriter->pstFile) != 0) {
+		cRet = RET_NG;
+	}
+	free(pstWriter->plIndex);
+
+	return cRet;
+}
+
+static int convert_def(
+	const char *pcFileName,
+	const char *pcOutFile
+) {
+
+	BATCH_STATS stBatch;
+	BIN_WRITER stWriter;
+	BIN_FILE stBin;
+	PATH_DEF pstSolution[MAX_DEFS + 1];
+	const unsigned char *pbRec;
+	FILE *pstFile;
+	char *pcBuf;
+	long iLen;
+	long i;
+	char cResult;
+	char cRet;
+
+	clear_def();
+
+	if (map_def(pcFileName, &pcBuf, &iLen) != RET_OK) {
+		return EXIT_ERROR;
+	}
+
+	memset(&stBatch, '\0', sizeof(BATCH_STATS));
+
+	if (!is_bin_def(pcBuf, iLen)) {
+
+		// eLXgϊƂ͉ɏo
+		cRet = open_bin_writer(&stWriter, pcOutFile);
+		if (cRet == RET_OK) {
+			stBatch.pstWriter = &stWriter;
+			stBatch.cConvert = FLG_ON;
+			parse_lines(pcBuf, pcBuf + iLen, pcFileName, &stBatch);
+			cRet = close_bin_writer(&stWriter);
+		}
+
+	} else {
+
+		cRet = open_bin(&stBin, pcFileName, pcBuf, iLen);
+		pstFile = NULL;
+		if (cRet == RET_OK) {
+			pstFile = fopen(pcOutFile, "w");
+			if (pstFile == NULL) {
+				printf("file open failed. file : %s, errno = %d\n", pcOutFile, errno);
+				cRet = RET_NG;
+			}
+		}
+
+		// ΌoH̍sƂďo
+		pbRec = stBin.pbBuf + BIN_HEADER_LEN;
+		for (i = 0; cRet == RET_OK && i < stBin.iCount; i++) {
+			stBatch.iPuzzles++;
+			if (read_bin(&stBin, &pbRec, i, &cResult, pstSolution) != RET_OK) {
+				printf("\n");
+				stBatch.iErrors++;
+				if (pbRec == NULL) {
+					break;
+				}
+				continue;
+			}
+			write_text_def(pstFile, (cResult == BIN_SOLVED) ? pstSolution : NULL);
+		}
+
+		if (pstFile != NULL && fclose(pstFile) != 0) {
+			cRet = RET_NG;
+		}
+	}
+
+	unmap_def(pcBuf, iLen);
+
+	if (cRet != RET_OK) {
+		printf("%s : convert failed.\n", pcOutFile);
+		return EXIT_ERROR;
+	}
+
+	printf("converted:%d, errors:%d\n", stBatch.iPuzzles - stBatch.iErrors, stBatch.iErrors);
+
+	return (stBatch.iErrors > 0) ? EXIT_ERROR : EXIT_SOLVED;
+}
+
+static void write_text_def(
+	FILE *pstFile,
+	pPATH_DEF pstSolution
+) {
+
+	pLINK_DEF pstLinkDef;
+	pPATH_DEF pstPathDef;
+	pPOINT pstPoint;
+
+	fprintf(pstFile, "size %d\n", gcSize);
+
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+		fprintf(pstFile, "link '%s'", pstLinkDef->pcLinkName);
+		for (pstPoint = pstLinkDef->pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			fprintf(pstFile, ", [%d,%d]", pstPoint->cRow, pstPoint->cCol);
+		}
+		fprintf(pstFile, "\n");
+	}
+
+	for (pstPathDef = (pstSolution != NULL) ? pstSolution : gpstPathDefs; HAS_LINK(pstPathDef); pstPathDef++) {
+		fprintf(pstFile, "path '%s'", pstPathDef->pcLinkName);
+		for (pstPoint = pstPathDef->pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			fprintf(pstFile, ", [%d,%d]", pstPoint->cRow, pstPoint->cCol);
+		}
+		fprintf(pstFile, "\n");
+	}
+
+	fprintf(pstFile, "\n");
+}
+
+static unsigned long get_le(
+	const unsigned char *pbBuf,
+	int iBytes
+) {
+
+	unsigned long lValue;
+
+	lValue = 0;
+	while (--iBytes >= 0) {
+		lValue = (lValue << 8) | pbBuf[iBytes];
+	}
+
+	return lValue;
+}
+
+static void set_le(
+	unsigned char *pbBuf,
+	unsigned long lValue,
+	int iBytes
+) {
+
+	int i;
+
+	for (i = 0; i < iBytes; i++) {
+		pbBuf[i] = (lValue >> (i * 8)) & 0xff;
+	}
+}
+
+static char get_bin_result(void) {
+
+	switch (gcStopReason) {
+	case STOP_SOLVED:
+		return BIN_SOLVED;
+	case STOP_NONE:
+		return BIN_UNSAT;
+	default:
+		return BIN_NONE;
+	}
+}
+
+static void init_tables(void) {
+
+	char cRow;
+	char cCol;
+
+	memset(gppcZeroExitPoints, '\0', sizeof(gppcZeroExitPoints));
+
+	for (cRow = 0; cRow < MAX_SIZE; cRow++) {
+		for (cCol = 0; cCol < MAX_SIZE; cCol++) {
+			gpplCellKeys[(int) cRow][(int) cCol] = mix_key(cRow * MAX_SIZE + cCol + 1);
+		}
+	}
+
+	init_arena();
+}
+
+static void init_arena(void) {
+
+	// qɂȂՖʂ̎ʂ͎̐ƃO[v̏o킹Ă ARENA_FRAMES ܂ŁB
+	// Gꂽy[WۂɎg
+	gstArena.iSize = ARENA_ROUND(sizeof(PROBE)) + ARENA_ROUND(sizeof(STATUS)) * ARENA_FRAMES;
+	gstArena.pcBase = mmap(
+		NULL,
+		gstArena.iSize,
+		PROT_READ | PROT_WRITE,
+		MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+		-1,
+		0
+	);
+	if (gstArena.pcBase == MAP_FAILED) {
+		printf("arena can not be allocated. errno = %d\n", errno);
+		exit(EXIT_ERROR);
+	}
+
+	gpstProbe = (pPROBE) gstArena.pcBase;
+	reset_arena();
+}
+
+static void *alloc_arena(
+	long iSize
+) {
+
+	void *pvPtr;
+
+	pvPtr = gstArena.pcBase + gstArena.iTop;
+	gstArena.iTop += ARENA_ROUND(iSize);
+	if (gstArena.iTop > gstArena.iPeak) {
+		gstArena.iPeak = gstArena.iTop;
+	}
+
+	return pvPtr;
+}
+
+static void reset_arena(void) {
+
+	// 擪͒חp̍Ɨ̈悪߂
+	gstArena.iTop = ARENA_ROUND(sizeof(PROBE));
+	gstArena.iPeak = gstArena.iTop;
+}
+
+static void init_globals(void) {
+
+	time(&gtStartTime);
+	giNodeCases = 0;
+	giOkCases = 0;
+	giBranchErrCases = 0;
+	giDeadEndCases = 0;
+	giDeadPartitionCases = 0;
+	giSplitLinkCases = 0;
+	giFd1DeadPartitionCases = 0;
+	giMultiSplitCases = 0;
+	giCorridorCases = 0;
+	giUnreachableCases = 0;
+	giShortLengthCases = 0;
+	giParityCases = 0;
+	giGroupCases = 0;
+	giGroupCutCases = 0;
+	giNogoodCases = 0;
+	giRestartCases = 0;
+	giSymmetryCases = 0;
+	giSolutionCases = 0;
+	glWeight = 1;
+	gcSymMask = 0;
+	gcSymPending = FLG_OFF;
+	giRestartLimit = 0;
+	reset_arena();
+	memset(gpppiHistory, '\0', sizeof(gpppiHistory));
+	memset(gpstNogoods, '\0', sizeof(gpstNogoods));
+	memset(gpstDepthBins, '\0', sizeof(gpstDepthBins));
+	memset(gpstFillBins, '\0', sizeof(gpstFillBins));
+	memset(gpcFd1Off, FLG_OFF, sizeof(gpcFd1Off));
+	giRootFilled = 0;
+	memset(gppstSchedStats, '\0', sizeof(gppstSchedStats));
+	memset(gplSchedSkips, '\0', sizeof(gplSchedSkips));
+	giLastDepth = -1;
+	giSchedCut = -1;
+
+	gtCheckpointTime = gtStartTime;
+	memset(gpcMoves, '\0', sizeof(gpcMoves));
+	giDepth = 0;
+	giResumeDepth = -1;
+	giTaskDepth = 0;
+	gcSplit = FLG_OFF;
+
+	giFrameCnt = 0;
+	giActiveFrame = -1;
+	giCutFrame = -1;
+	glFocusParts = ALL_PARTS;
+	gcGroupChild = FLG_OFF;
+
+	gdDeadline = get_clock() + gdTimeLimit;
+	giNextCheck = CHECK_INTERVAL;
+	if (giMaxNodes > 0 && giMaxNodes < giNextCheck) {
+		giNextCheck = giMaxNodes;
+	}
+	gcStopReason = STOP_NONE;
+
+}
+
+static char solve(void) {
+
+	char cRet;
+	char cStore;
+
+	// ĂoHƌ`ł͌ʂ܂Ȃ
+	cStore = FLG_OFF;
+	if (gpstCache != NULL && !HAS_LINK(gpstPathDefs) && gcCount == FLG_OFF) {
+		cStore = FLG_ON;
+	}
+
+	if (cStore == FLG_ON && solve_cached() == RET_OK) {
+		cRet = RET_OK;
+		cStore = FLG_OFF;
+	} else if (gpcIncrementalFile != NULL) {
+		cRet = solve_incremental(gpcIncrementalFile);
+	} else {
+		cRet = solve_once();
+	}
+
+	if (cRet != RET_OK) {
+		return RET_NG;
+	}
+
+	if (gcCount == FLG_ON && gcStopReason == STOP_NONE && giSolutionCases > 0) {
+		gcStopReason = STOP_SOLVED;
+	}
+
+	if (cStore == FLG_ON && (gcStopReason == STOP_SOLVED || gcStopReason == STOP_NONE)) {
+		store_cache();
+	}
+
+	print_solution();
+
+	return RET_OK;
+}
+
+static char solve_once(void) {
+
+	STATUS stStatus;
+	long iCells;
+
+	if (init_status(&stStatus) != RET_OK) {
+		return RET_NG;
+	}
+	close_connected_links(&stStatus);
+
+	if (HAS_LINK(gpstPathDefs)) {
+		iCells = apply_paths(&stStatus);
+		if (iCells < 0) {
+			return RET_NG;
+		}
+		if (gcQuiet == FLG_OFF) {
+			printf("\npath:%ld cells\n", iCells);
+		}
+	}
+
+	if (gcPresolve == FLG_ON) {
+		iCells = presolve(&stStatus);
+		if (gcQuiet == FLG_OFF) {
+			printf("\npresolve:%ld cells\n", iCells);
+		}
+	}
+
+	gcSymMask = 0;
+	if (gcSymmetry == FLG_ON) {
+		gcSymMask = get_automorphisms(&stStatus);
+		if (gcQuiet == FLG_OFF && gcSymMask != 0) {
+			printf("\nsymmetry:%d\n", __builtin_popcount((unsigned char) gcSymMask) + 1);
+		}
+	}
+
+	if (gcQuiet == FLG_OFF) {
+		print_status(&stStatus);
+	}
+	DEBUG_DUMP((char *) &stStatus, sizeof(stStatus));
+
+	search(&stStatus);
+
+	return RET_OK;
+}
+
+static char solve_incremental(
+	const char *pcFileName
+) {
+
+	char ppcDist[MAX_SIZE][MAX_SIZE];
+	pPATH_DEF pstPathDef;
+	int iRadius;
+	int iKept;
+	int iPrevKept;
+
+	pstPathDef = gpstPathDefs;
+	while (HAS_LINK(pstPathDef)) {
+		pstPathDef++;
+	}
+
+	if (
+		load_state(pcFileName) == RET_OK
+		&& gstIncrState.cSolved == FLG_ON
+		&& gstIncrState.cSize == gcSize
+	) {
+		get_edit_distance(ppcDist);
+
+		// ύX_痣ꂽN͑ǑoĤ܂܎cAc肾T
+		iPrevKept = -1;
+		for (iRadius = INCR_RADIUS; iRadius < gcSize * 2; iRadius *= 2) {
+
+			iKept = add_kept_paths(ppcDist, iRadius, pstPathDef);
+			if (iKept == 0) {
+				break;
+			}
+
+			if (iKept != iPrevKept) {
+				if (gcQuiet == FLG_OFF) {
+					printf("\nrepair:radius %d, kept %d links\n", iRadius, iKept);
+				}
+				reset_search();
+				if (solve_once() == RET_OK && gcStopReason != STOP_NONE) {
+					memset(pstPathDef, '\0', sizeof(PATH_DEF) * iKept);
+					save_state(pcFileName);
+					return RET_OK;
+				}
+			}
+
+			memset(pstPathDef, '\0', sizeof(PATH_DEF) * iKept);
+			iPrevKept = iKept;
+		}
+
+		if (gcQuiet == FLG_OFF) {
+			printf("\nrepair:failed, nodes:%ld\n", giNodeCases);
+		}
+		reset_search();
+	}
+
+	if (solve_once() != RET_OK) {
+		return RET_NG;
+	}
+
+	save_state(pcFileName);
+
+	return RET_OK;
+}
+
+static void reset_search(void) {
+
+	giDepth = 0;
+	giFrameCnt = 0;
+	giActiveFrame = -1;
+	giCutFrame = -1;
+	glFocusParts = ALL_PARTS;
+	gcStopReason = STOP_NONE;
+}
+
+static char open_cache(
+	const char *pcFileName
+) {
+
+	int iFd;
+	off_t lSize;
+
+	iFd = open(pcFileName, O_RDWR | O_CREAT, 0644);
+	if (iFd < 0) {
+		printf("cache open failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	lSize = lseek(iFd, 0, SEEK_END);
+	if (lSize == 0) {
+		if (ftruncate(iFd, sizeof(CACHE_FILE)) != 0) {
+			printf("cache write failed. file : %s, errno = %d\n", pcFileName, errno);
+			close(iFd);
+			return RET_NG;
+		}
+	} else if (lSize != sizeof(CACHE_FILE)) {
+		printf("%s : not a cache file.\n", pcFileName);
+		close(iFd);
+		return RET_NG;
+	}
+
+	gpstCache = mmap(NULL, sizeof(CACHE_FILE), PROT_READ | PROT_WRITE, MAP_SHARED, iFd, 0);
+	close(iFd);
+	if (gpstCache == MAP_FAILED) {
+		printf("mmap failed. errno = %d\n", errno);
+		gpstCache = NULL;
+		return RET_NG;
+	}
+
+	if (lSize == 0) {
+		memcpy(gpstCache->pcMagic, CACHE_MAGIC, sizeof(gpstCache->pcMagic));
+		gpstCache->cVersion = CACHE_VERSION;
+	} else if (
+		memcmp(gpstCache->pcMagic, CACHE_MAGIC, sizeof(gpstCache->pcMagic)) != 0
+		|| gpstCache->cVersion != CACHE_VERSION
+	) {
+		printf("%s : not a cache file.\n", pcFileName);
+		munmap(gpstCache, sizeof(CACHE_FILE));
+		gpstCache = NULL;
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static char solve_cached(void) {
+
+	pCACHE_ENTRY pstEntry;
+	pLINK_DEF pstLinkDef;
+	pLINK_DEF pstCanonDef;
+	pPATH_DEF pstPathDef;
+	pPOINT pstPoint;
+	pPOINT pstLast;
+	POINT ppstInverse[MAX_SIZE][MAX_SIZE];
+	POINT pstWalk[MAX_PATH_POINTS + 1];
+	POINT stPoint;
+	unsigned long lKey;
+	unsigned char cCell;
+	char cMode;
+	char cRet;
+	int iLen;
+	int i;
+	int j;
+
+	cMode = get_cache_mode();
+	lKey = get_cache_key(cMode);
+	pstEntry = gpstCache->pstEntries + (lKey & CACHE_MASK);
+
+	if (
+		pstEntry->lKey != lKey
+		|| pstEntry->cSize != gcSize
+		|| pstEntry->cMode != cMode
+		|| memcmp(pstEntry->pstLinkDefs, gpstCanonDefs, sizeof(gpstCanonDefs)) != 0
+	) {
+		return RET_NG;
+	}
+
+	if (gcQuiet == FLG_OFF) {
+		printf("\ncache:hit, sym:%d\n", gcCanonSym);
+	}
+
+	if (pstEntry->cResult == STOP_NONE) {
+		gcStopReason = STOP_NONE;
+		return RET_OK;
+	}
+
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+			get_sym_point(&stPoint, gcCanonSym, pstWalk);
+			ppstInverse[(int) pstWalk->cRow][(int) pstWalk->cCol] = stPoint;
+		}
+	}
+
+	// K`̔ՖʂǂoȞƖOɖ߂āAĂoHƂė^
+	cRet = RET_OK;
+	for (pstLinkDef = gpstLinkDefs, pstPathDef = gpstPathDefs; HAS_LINK(pstLinkDef) && cRet == RET_OK; pstLinkDef++, pstPathDef++) {
+
+		i = pstLinkDef - gpstLinkDefs;
+		pstCanonDef = gpstCanonDefs + gpcCanonIndex[i];
+		for (pstLast = pstCanonDef->pstPoints; HAS_POINT((pstLast + 1)); pstLast++);
+
+		iLen = 0;
+		pstWalk[iLen] = pstCanonDef->pstPoints[0];
+		while (memcmp(pstWalk + iLen, pstLast, sizeof(POINT)) != 0) {
+
+			cCell = pstEntry->ppcCells[(int) pstWalk[iLen].cRow][(int) pstWalk[iLen].cCol];
+			stPoint.cRow = pstWalk[iLen].cRow + gpstDirections[CELL_DIR(cCell)].cRowDelta;
+			stPoint.cCol = pstWalk[iLen].cCol + gpstDirections[CELL_DIR(cCell)].cColDelta;
+
+			if (
+				CELL_LINK(cCell) != gpcCanonIndex[i] + 1
+				|| iLen >= MAX_PATH_POINTS - 1
+				|| stPoint.cRow < 0 || stPoint.cRow >= gcSize
+				|| stPoint.cCol < 0 || stPoint.cCol >= gcSize
+			) {
+				cRet = RET_NG;
+				break;
+			}
+
+			pstWalk[++iLen] = stPoint;
+		}
+
+		strcpy(pstPathDef->pcLinkName, pstLinkDef->pcLinkName);
+		for (j = 0, pstPoint = pstPathDef->pstPoints; j <= iLen; j++, pstPoint++) {
+			stPoint = pstWalk[gpcCanonReversed[i] == FLG_ON ? iLen - j : j];
+			*pstPoint = ppstInverse[(int) stPoint.cRow][(int) stPoint.cCol];
+		}
+		pstPoint->cRow = -1;
+		pstPoint->cCol = -1;
+	}
+
+	if (cRet == RET_OK) {
+		cRet = solve_once();
+	}
+	memset(gpstPathDefs, '\0', sizeof(gpstPathDefs));
+
+	// ꂽڂƂ͕ʂɉ
+	if (cRet != RET_OK || gcStopReason != STOP_SOLVED) {
+		reset_search();
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static void store_cache(void) {
+
+	pCACHE_ENTRY pstEntry;
+	pLINK_DEF pstLinkDef;
+	PATH_DEF stPathDef;
+	pPOINT pstPoint;
+	POINT stFrom;
+	POINT stTo;
+	unsigned long lKey;
+	char cMode;
+	char cLink;
+	char cDir;
+	int iLen;
+	int i;
+	int j;
+
+	cMode = get_cache_mode();
+	lKey = get_cache_key(cMode);
+	pstEntry = gpstCache->pstEntries + (lKey & CACHE_MASK);
+
+	// ̍ڂǂ܂Ȃ悤A͍Ōɏ
+	pstEntry->lKey = 0;
+	pstEntry->cSize = gcSize;
+	pstEntry->cResult = gcStopReason;
+	pstEntry->cMode = cMode;
+	memcpy(pstEntry->pstLinkDefs, gpstCanonDefs, sizeof(gpstCanonDefs));
+	memset(pstEntry->ppcCells, '\0', sizeof(pstEntry->ppcCells));
+
+	if (gcStopReason == STOP_SOLVED) {
+		for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+
+			i = pstLinkDef - gpstLinkDefs;
+			if (get_solution_path(&gstSolution, pstLinkDef, &stPathDef) != RET_OK) {
+				return;
+			}
+
+			for (iLen = 0, pstPoint = stPathDef.pstPoints; HAS_POINT(pstPoint); iLen++, pstPoint++);
+
+			// K`ł̌ɕגAe}XɎ̃}Xւ̌
+			cLink = gpcCanonIndex[i] + 1;
+			for (j = 0; j < iLen; j++) {
+
+				get_sym_point(stPathDef.pstPoints + (gpcCanonReversed[i] == FLG_ON ? iLen - 1 - j : j), gcCanonSym, &stFrom);
+				cDir = 0;
+				if (j + 1 < iLen) {
+					get_sym_point(stPathDef.pstPoints + (gpcCanonReversed[i] == FLG_ON ? iLen - 2 - j : j + 1), gcCanonSym, &stTo);
+					for (cDir = 0; cDir < NEIGHBOR_CNT; cDir++) {
+						if (
+							stFrom.cRow + gpstDirections[(int) cDir].cRowDelta == stTo.cRow
+							&& stFrom.cCol + gpstDirections[(int) cDir].cColDelta == stTo.cCol
+						) {
+							break;
+						}
+					}
+				}
+
+				pstEntry->ppcCells[(int) stFrom.cRow][(int) stFrom.cCol] = MAKE_CELL(cLink, cDir);
+			}
+		}
+	}
+
+	pstEntry->lKey = lKey;
+}
+
+static unsigned long get_cache_key(
+	char cMode
+) {
+
+	// T̎dςw肪Ⴆ΁A`łʂ̍ڂɂ
+	return get_canonical_def() ^ ((unsigned long) cMode * 0x9e3779b97f4a7c15UL);
+}
+
+static char get_cache_mode(void) {
+
+	char cMode;
+
+	cMode = 0;
+	if (gcPresolve == FLG_OFF) {
+		cMode |= CACHE_NO_PRESOLVE;
+	}
+	if (gcSymmetry == FLG_OFF) {
+		cMode |= CACHE_NO_SYMMETRY;
+	}
+	if (gcAutoTune == FLG_ON) {
+		cMode |= CACHE_AUTO_TUNE;
+	}
+	if (gcSchedule == FLG_ON) {
+		cMode |= CACHE_SCHEDULE;
+	}
+	if (gcNogood == FLG_OFF) {
+		cMode |= CACHE_NO_NOGOOD;
+	}
+
+	return cMode;
+}
+
+static unsigned long get_canonical_def(void) {
+
+	LINK_DEF pstSeqs[MAX_DEFS + 1];
+	LINK_DEF pstCands[MAX_DEFS + 1];
+	POINT pstReversed[MAX_POINTS + 1];
+	pPOINT pstPoint;
+	char pcOrder[MAX_DEFS];
+	char pcReversed[MAX_DEFS];
+	unsigned char *pbByte;
+	unsigned long lHash;
+	char cSym;
+	char cTmp;
+	int iCnt;
+	int iLen;
+	int i;
+	int j;
+
+	for (iCnt = 0; HAS_LINK((gpstLinkDefs + iCnt)); iCnt++);
+
+	// 8ʂ̌̂ANʒuɕׂ񂪍ŏɂȂ̂𐳋K`Ƃ
+	for (cSym = 0; cSym < SYM_CNT; cSym++) {
+
+		memset(pstSeqs, '\0', sizeof(pstSeqs));
+		for (i = 0; i < iCnt; i++) {
+
+			for (iLen = 0, pstPoint = gpstLinkDefs[i].pstPoints; HAS_POINT(pstPoint); iLen++, pstPoint++) {
+				get_sym_point(pstPoint, cSym, pstSeqs[i].pstPoints + iLen);
+			}
+			pstSeqs[i].pstPoints[iLen].cRow = -1;
+			pstSeqs[i].pstPoints[iLen].cCol = -1;
+
+			// Ɍ͂Ȃ̂ŁA[_ׂ̏
+			for (j = 0; j < iLen; j++) {
+				pstReversed[j] = pstSeqs[i].pstPoints[iLen - 1 - j];
+			}
+			pstReversed[iLen] = pstSeqs[i].pstPoints[iLen];
+
+			pcReversed[i] = FLG_OFF;
+			if (compare_points(pstReversed, pstSeqs[i].pstPoints) < 0) {
+				memcpy(pstSeqs[i].pstPoints, pstReversed, sizeof(POINT) * iLen);
+				pcReversed[i] = FLG_ON;
+			}
+
+			for (j = i; j > 0 && compare_points(pstSeqs[(int) pcOrder[j - 1]].pstPoints, pstSeqs[i].pstPoints) > 0; j--) {
+				pcOrder[j] = pcOrder[j - 1];
+			}
+			pcOrder[j] = i;
+		}
+
+		memset(pstCands, '\0', sizeof(pstCands));
+		for (j = 0; j < iCnt; j++) {
+			snprintf(pstCands[j].pcLinkName, sizeof(pstCands[j].pcLinkName), "%d", j + 1);
+			memcpy(pstCands[j].pstPoints, pstSeqs[(int) pcOrder[j]].pstPoints, sizeof(pstCands[j].pstPoints));
+		}
+
+		if (cSym > 0 && memcmp(pstCands, gpstCanonDefs, sizeof(pstCands)) >= 0) {
+			continue;
+		}
+
+		memcpy(gpstCanonDefs, pstCands, sizeof(pstCands));
+		gcCanonSym = cSym;
+		for (j = 0; j < iCnt; j++) {
+			cTmp = pcOrder[j];
+			gpcCanonIndex[(int) cTmp] = j;
+			gpcCanonReversed[(int) cTmp] = pcReversed[(int) cTmp];
+		}
+	}
+
+	// FNV-1a
+	lHash = 14695981039346656037UL;
+	lHash = (lHash ^ (unsigned char) gcSize) * 1099511628211UL;
+	for (pbByte = (unsigned char *) gpstCanonDefs; pbByte < (unsigned char *) (gpstCanonDefs + MAX_DEFS + 1); pbByte++) {
+		lHash = (lHash ^ *pbByte) * 1099511628211UL;
+	}
+	if (lHash == 0) {
+		lHash = 1;
+	}
+
+	return lHash;
+}
+
+static void get_sym_point(
+	pPOINT pstFrom,
+	char cSym,
+	pPOINT pstTo
+) {
+
+	char cRow;
+	char cCol;
+	char cTmp;
+	int i;
+
+	cRow = pstFrom->cRow;
+	cCol = pstFrom->cCol;
+
+	// E̔]̂Ƃ 90 x
+	if (cSym & 4) {
+		cCol = gcSize - 1 - cCol;
+	}
+	for (i = 0; i < (cSym & 3); i++) {
+		cTmp = cRow;
+		cRow = cCol;
+		cCol = gcSize - 1 - cTmp;
+	}
+
+	pstTo->cRow = cRow;
+	pstTo->cCol = cCol;
+}
+
+static int compare_points(
+	pPOINT pstPoints1,
+	pPOINT pstPoints2
+) {
+
+	for (; HAS_POINT(pstPoints1) && HAS_POINT(pstPoints2); pstPoints1++, pstPoints2++) {
+		if (pstPoints1->cRow != pstPoints2->cRow) {
+			return pstPoints1->cRow - pstPoints2->cRow;
+		}
+		if (pstPoints1->cCol != pstPoints2->cCol) {
+			return pstPoints1->cCol - pstPoints2->cCol;
+		}
+	}
+
+	return HAS_POINT(pstPoints1) - HAS_POINT(pstPoints2);
+}
+
+static char get_automorphisms(
+	pSTATUS pstStatus
+) {
+
+	char cSymMask;
+	char cSym;
+
+	cSymMask = 0;
+	for (cSym = 1; cSym < SYM_CNT; cSym++) {
+		if (is_automorphism(pstStatus, cSym) == RET_OK) {
+			cSymMask |= 1 << cSym;
+		}
+	}
+
+	return cSymMask;
+}
+
+static char is_automorphism(
+	pSTATUS pstStatus,
+	char cSym
+) {
+
+	int piPerm[LINK_ID_CNT];
+	int piInverse[LINK_ID_CNT];
+	pLINK_PART pstLinkPart;
+	pLINK_PART pstLinkPart2;
+	POINT stPoint;
+	POINT stPoint2;
+	POINT stStart;
+	POINT stEnd;
+	char *pcStat;
+	char *pcStat2;
+	int iLink;
+	int iLink2;
+
+	memset(piPerm, -1, sizeof(piPerm));
+	memset(piInverse, -1, sizeof(piInverse));
+
+	// ܂}X̓N̕tւۂ܂ܖ܂}X֎ʂȂ΂ȂȂ
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			get_sym_point(&stPoint, cSym, &stPoint2);
+			pcStat = get_stat(pstStatus, &stPoint);
+			pcStat2 = get_stat(pstStatus, &stPoint2);
+
+			if ((*pcStat == '\0') != (*pcStat2 == '\0')) {
+				return RET_NG;
+			}
+			if (*pcStat == '\0') {
+				continue;
+			}
+
+			iLink = atoi(pcStat);
+			iLink2 = atoi(pcStat2);
+			if (piPerm[iLink] < 0 && piInverse[iLink2] < 0) {
+				piPerm[iLink] = iLink2;
+				piInverse[iLink2] = iLink;
+			} else if (piPerm[iLink] != iLink2) {
+				return RET_NG;
+			}
+		}
+	}
+
+	// L΂Ă镔̗[́A킸tւ̗̕[֎ʂ
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+
+		if (pstLinkPart->cClose == FLG_ON) {
+			continue;
+		}
+
+		get_sym_point(&(pstLinkPart->stStart), cSym, &stStart);
+		get_sym_point(&(pstLinkPart->stEnd), cSym, &stEnd);
+
+		for (pstLinkPart2 = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart2); pstLinkPart2++) {
+			if (
+				pstLinkPart2->cClose == FLG_OFF
+				&& atoi(pstLinkPart2->pcLinkName) == piPerm[atoi(pstLinkPart->pcLinkName)]
+				&& (
+					(memcmp(&(pstLinkPart2->stStart), &stStart, sizeof(POINT)) == 0 && memcmp(&(pstLinkPart2->stEnd), &stEnd, sizeof(POINT)) == 0)
+					|| (memcmp(&(pstLinkPart2->stStart), &stEnd, sizeof(POINT)) == 0 && memcmp(&(pstLinkPart2->stEnd), &stStart, sizeof(POINT)) == 0)
+				)
+			) {
+				break;
+			}
+		}
+
+		if (!HAS_LINK(pstLinkPart2)) {
+			return RET_NG;
+		}
+	}
+
+	return RET_OK;
+}
+
+static char get_sym_stabilizer(
+	pPOINT pstPoint,
+	char cSymMask
+) {
+
+	POINT stPoint;
+	char cStab;
+	char cSym;
+
+	cStab = 0;
+	for (cSym = 1; cSym < SYM_CNT; cSym++) {
+		if ((cSymMask & (1 << cSym)) == 0) {
+			continue;
+		}
+		get_sym_point(pstPoint, cSym, &stPoint);
+		if (memcmp(&stPoint, pstPoint, sizeof(POINT)) == 0) {
+			cStab |= 1 << cSym;
+		}
+	}
+
+	return cStab;
+}
+
+static int get_sym_orbit(
+	pNEIGHBOR pstNeighbors,
+	pNEIGHBOR pstNeighbor,
+	char cSymMask,
+	char *pcFixMask
+) {
+
+	POINT pstImages[SYM_CNT];
+	POINT stPoint;
+	pNEIGHBOR pstPrev;
+	char cSym;
+	int iOrbit;
+	int i;
+
+	*pcFixMask = 0;
+	pstImages[0] = pstNeighbor->stPoint;
+	iOrbit = 1;
+
+	for (cSym = 1; cSym < SYM_CNT; cSym++) {
+
+		if ((cSymMask & (1 << cSym)) == 0) {
+			continue;
+		}
+
+		get_sym_point(&(pstNeighbor->stPoint), cSym, &stPoint);
+		if (memcmp(&stPoint, &(pstNeighbor->stPoint), sizeof(POINT)) == 0) {
+			*pcFixMask |= 1 << cSym;
+			continue;
+		}
+
+		// Oɕ񂾎֎ʂȂA̎Œ׍ς
+		for (pstPrev = pstNeighbors; pstPrev < pstNeighbor; pstPrev++) {
+			if (memcmp(&stPoint, &(pstPrev->stPoint), sizeof(POINT)) == 0) {
+				return -1;
+			}
+		}
+
+		for (i = 0; i < iOrbit; i++) {
+			if (memcmp(&stPoint, pstImages + i, sizeof(POINT)) == 0) {
+				break;
+			}
+		}
+		if (i >= iOrbit) {
+			pstImages[iOrbit++] = stPoint;
+		}
+	}
+
+	return iOrbit;
+}
+
+static char is_covered(
+	pSTATUS pstStatus
+) {
+
+	POINT stPoint;
+
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+			if (has_stat(pstStatus, &stPoint) != RET_OK) {
+				return RET_NG;
+			}
+		}
+	}
+
+	return RET_OK;
+}
+
+static char get_sym_pair_dir(
+	pSTATUS pstStatus,
+	char *pcDir
+) {
+
+	POINT stNext;
+	POINT stPoint;
+	char cLines;
+	char c;
+
+	// ̒[VLтT (r܂ŐLт[Ȃ痈ɕtĂ)
+	cLines = get_sym_pair_lines(pstStatus) & ~gcSymPairLines;
+	if (cLines == 0) {
+		return RET_NG;
+	}
+
+	for (c = 0; (cLines & (1 << c)) == 0; c++);
+	stNext.cRow = gstSymPair.cRow + gpstDirections[(int) c].cRowDelta;
+	stNext.cCol = gstSymPair.cCol + gpstDirections[(int) c].cColDelta;
+
+	// ̎A̒[猩ɒ
+	get_sym_point(&stNext, gcSymPairSym, &stPoint);
+	for (c = 0; c < NEIGHBOR_CNT; c++) {
+		if (
+			gstSymHead.cRow + gpstDirections[(int) c].cRowDelta == stPoint.cRow
+			&& gstSymHead.cCol + gpstDirections[(int) c].cColDelta == stPoint.cCol
+		) {
+			break;
+		}
+	}
+
+	*pcDir = c;
+
+	return RET_OK;
+}
+
+static char get_sym_pair_lines(
+	pSTATUS pstStatus
+) {
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	char cLines;
+
+	get_neighbors(&gstSymPair, pstNeighbors);
+
+	// ̒[ŁA̒ʂĂW߂
+	cLines = 0;
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+		if (get_line_dir(pstStatus, &gstSymPair, pstNeighbor) != DIR_NONE) {
+			cLines |= 1 << (pstNeighbor->pstDir - gpstDirections);
+		}
+	}
+
+	return cLines;
+}
+
+static char init_status(
+	pSTATUS pstStatus
+) {
+
+	pLINK_DEF pstLinkDef;
+	pLINK_PART pstLinkPart;
+	pLINK_PART pstPrevLink;
+	pPOINT pstFrom;
+	pPOINT pstTo;
+
 	memset(pstStatus, '\0', sizeof(STATUS));
 	pstLinkPart = pstStatus->pstLinkParts;
 
-	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+
+		pstPrevLink = NULL;
+
+		for (pstFrom = pstLinkDef->pstPoints; HAS_POINT(pstFrom); pstFrom++) {
+
+			pstTo = pstFrom + 1;
+
+			if (pstTo->cRow >= 0) {
+
+				if ((pstLinkPart - pstStatus->pstLinkParts) >= MAX_PARTS) {
+					printf("error : link parts count exceeded %d", MAX_PARTS);
+					return RET_NG;
+				}
+
+				memcpy(pstLinkPart->pcLinkName, pstLinkDef->pcLinkName, STAT_LEN);
+				memcpy(&(pstLinkPart->stStart), pstFrom, sizeof(POINT));
+				memcpy(&(pstLinkPart->stEnd), pstTo, sizeof(POINT));
+
+				if (pstPrevLink == NULL) {
+					pstLinkPart->cPrev = -1;
+					open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, START_MARK);
+				} else {
+					pstPrevLink->cNext = pstLinkPart - pstStatus->pstLinkParts;
+					pstLinkPart->cPrev = pstPrevLink - pstStatus->pstLinkParts;
+					open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, MID_MARK);
+				}
+
+				pstPrevLink = pstLinkPart;
+				pstLinkPart++;
+
+			} else {
+				pstPrevLink->cNext = -1;
+				open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, END_MARK);
+			}
+		}
+	}
+
+	memset(pstStatus->ppcDirs, DIR_NONE, sizeof(pstStatus->ppcDirs));
+
+	return RET_OK;
+}
+
+static void close_connected_links(
+	pSTATUS pstStatus
+) {
+
+	pLINK_PART pstLinkPart;
+
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		close_connected_link(pstStatus, pstLinkPart);
+	}
+}
+
+static void answer_gen(
+	pSTATUS pstStatus
+) {
+	pLINK_PART pstLinkPart;
+	POINT stPoint;
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	pDIRECTION pstDir;
+	long iNodeCases;
+	long iArenaTop;
+
+	POINT stPoint2;
+	pSTATUS pstStatus2;
+	pLINK_PART pstLinkPart2;
+
+	char cDirBit;
+	char cTried;
+
+	unsigned long long plGroups[MAX_PARTS];
+	char cGroupCnt;
+	int iFrame;
+
+	NOGOOD stFirstKey;
+	char cComplete;
+
+	char cSymMask;
+	char cStab;
+	char cFixMask;
+	char cPending;
+	char cDirB;
+	int iOrbit;
+
+	// \Z̊mF͈m[hƂɂ܂Ƃ߂čs
+	if (giNodeCases >= giNextCheck) {
+		check_limits();
+	}
+	if (gcStopReason != STOP_NONE) {
+		return;
+	}
+	// ĊJɒʂm[h͎sς݂̎ǂݔ΂̂ŁAsoȂ
+	cComplete = FLG_OFF;
+	if (giDepth >= giResumeDepth) {
+		giNodeCases++;
+		cComplete = FLG_ON;
+		if (gcProfile == FLG_ON) {
+			add_profile_node();
+		}
+	}
+
+	pstLinkPart = get_focus_link(pstStatus);
+
+	// ׂԈ菇́AƂĎ󂯎Oɔ΂ׂς܂
+	if (pstLinkPart == NULL && gcSchedule == FLG_ON && check_skipped(giDepth) != RET_OK) {
+		PRUNE_EVENT(gcPruneReason);
+		return;
+	}
+
+	if (pstLinkPart == NULL && giActiveFrame >= 0) {
+		next_group(pstStatus);
+		return;
+	}
+
+	// ͑S}X𖄂߂Ֆʂ (O[vɕǂAグǂɂȂ)
+	if (pstLinkPart == NULL && is_covered(pstStatus) != RET_OK) {
+		giDeadPartitionCases++;
+		PRUNE_EVENT(PRUNE_DEAD_PARTITION);
+		return;
+	}
+
+	// グł͉d݂̕āAT𑱂
+	if (pstLinkPart == NULL && gcCount == FLG_ON) {
+		if (giSolutionCases == 0) {
+			memcpy(&gstSolution, pstStatus, sizeof(STATUS));
+		}
+		giSolutionCases += glWeight;
+		TRACE_EVENT(TRACE_SOLVED, 0);
+		return;
+	}
+
+	if (pstLinkPart == NULL) {
+		DEBUG_PRINTF("\n----- !!!!!solved!!!!! -----");
+		memcpy(&gstSolution, pstStatus, sizeof(STATUS));
+		gcStopReason = STOP_SOLVED;
+		TRACE_EVENT(TRACE_SOLVED, 0);
+		return;
+	}
+
+	if (run_checks(pstStatus, plGroups, &cGroupCnt) != RET_OK) {
+		PRUNE_EVENT(gcPruneReason);
+		return;
+	}
+
+	print_progress(pstStatus);
+
+	// [ɒƗO[vɕꂽA܂ł̎菇z镔؂̍ɂ
+	if (gcSplit == FLG_ON && (giDepth >= giSplitDepth || (cGroupCnt > 1 && gcCount == FLG_OFF))) {
+		add_task();
+		return;
+	}
+
+	// ݂ɊւȂV}ɕꂽAO[vƂɏɉ
+	iFrame = -1;
+	memset(&stFirstKey, '\0', sizeof(NOGOOD));
+	if (cGroupCnt > 1 && gcCount == FLG_OFF) {
+
+		// O[v̉ȂôŁA܂ł̎菇͒׏IĂ
+		if (gcSchedule == FLG_ON && check_skipped(giDepth + 1) != RET_OK) {
+			PRUNE_EVENT(gcPruneReason);
+			return;
+		}
+
+		// ǂꂩ 1 łȂƕĂO[vΖ߂
+		if (has_nogood_group(pstStatus, plGroups, cGroupCnt, &stFirstKey) == RET_OK) {
+			giNogoodCases++;
+			PRUNE_EVENT(PRUNE_NOGOOD);
+			return;
+		}
+
+		giGroupCases++;
+		iFrame = push_frame(plGroups, cGroupCnt);
+		pstLinkPart = get_focus_link(pstStatus);
+
+		if (is_parallel(plGroups, cGroupCnt) == RET_OK) {
+			fork_groups(pstStatus, iFrame);
+			pop_frame(iFrame);
+			return;
+		}
+	}
+
+	stPoint = pstLinkPart->stStart;
+	get_neighbors(&stPoint, pstNeighbors);
+	if (gcRandomize == FLG_ON) {
+		shuffle_neighbors(pstNeighbors);
+	}
+	if (gcOrder != ORDER_FIXED) {
+		order_neighbors(pstStatus, pstLinkPart, pstNeighbors);
+	}
+
+	// ĊJ͋L^肩i߁Asς݂͓̕ǂݔ΂
+	cTried = 0;
+	if (giDepth < giResumeDepth) {
+		cTried = MOVE_TRIED(gpcMoves[giDepth]);
+		put_first_neighbor(pstNeighbors, MOVE_DIR(gpcMoves[giDepth]));
+	}
+
+	// ՖʂƐL΂[ۂΏ̂΁Aʂ荇 1 ׂ
+	cSymMask = gcSymMask;
+	cStab = 0;
+	if (cSymMask != 0) {
+		cStab = get_sym_stabilizer(&stPoint, cSymMask);
+	}
+
+	// i߂Ֆʂ͂̐[̎ʂɍ蒼
+	iArenaTop = gstArena.iTop;
+	pstStatus2 = alloc_arena(sizeof(STATUS));
+
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+		stPoint2 = pstNeighbor->stPoint;
+		pstDir = pstNeighbor->pstDir;
+		cDirBit = 1 << (pstDir - gpstDirections);
+
+		if ((cTried & cDirBit) != 0) {
+			continue;
+		}
+
+		// 󂯎؂̍܂ł͔zꂽ肾i߂
+		if (giDepth < giTaskDepth && pstDir - gpstDirections != MOVE_DIR(gpcMoves[giDepth])) {
+			continue;
+		}
+
+		if (has_stat(pstStatus, &stPoint2) == RET_OK) {
+			continue;
+		}
+
+		if (check_branch(pstStatus, &stPoint2, pstLinkPart->pcLinkName) != RET_OK) {
+			PRUNE_EVENT(PRUNE_BRANCH);
+			cTried |= cDirBit;
+			continue;
+		}
+
+		iOrbit = 1;
+		cFixMask = 0;
+		cPending = gcSymPending;
+		if (cStab != 0) {
+			iOrbit = get_sym_orbit(pstNeighbors, pstNeighbor, cStab, &cFixMask);
+			if (iOrbit < 0) {
+				giSymmetryCases++;
+				PRUNE_EVENT(PRUNE_SYMMETRY);
+				cTried |= cDirBit;
+				continue;
+			}
+		} else if (gcCount == FLG_ON && cSymMask != 0 && (cSymMask & (cSymMask - 1)) == 0) {
+			// Ώ̂ЂƂ̐܂ԂȂAƂ̋̂
+			// ̒[ł̎肪̓[ł̎ȉɂȂ𐔂
+			for (gcSymPairSym = 1; (cSymMask & (1 << gcSymPairSym)) == 0; gcSymPairSym++);
+			gstSymHead = stPoint;
+			get_sym_point(&stPoint, gcSymPairSym, &gstSymPair);
+			gcSymPairLines = get_sym_pair_lines(pstStatus);
+			gcSymFirst = pstDir - gpstDirections;
+			gcSymPending = FLG_ON;
+		}
+
+		memcpy(pstStatus2, pstStatus, sizeof(STATUS));
+		pstLinkPart2 = pstStatus2->pstLinkParts + (pstLinkPart - pstStatus->pstLinkParts);
+		move_link(pstStatus2, pstLinkPart2, pstNeighbor);
+
+		if (gcSymPending == FLG_ON && get_sym_pair_dir(pstStatus2, &cDirB) == RET_OK) {
+			if (gcSymFirst > cDirB) {
+				gcSymPending = cPending;
+				giSymmetryCases++;
+				PRUNE_EVENT(PRUNE_SYMMETRY);
+				cTried |= cDirBit;
+				continue;
+			}
+			// 肪Ⴆ΋̉͐ɍς܂Ƃ 2 {
+			if (gcSymFirst < cDirB) {
+				iOrbit *= 2;
+			}
+			gcSymPending = FLG_OFF;
+		}
+
+		gpcMoves[giDepth] = MAKE_MOVE(pstDir - gpstDirections, cTried);
+		iNodeCases = giNodeCases;
+		gcSymMask = cFixMask;
+		glWeight *= iOrbit;
+		TRACE_EVENT(TRACE_MOVE, TRACE_ARG(pstLinkPart - pstStatus->pstLinkParts, pstDir - gpstDirections));
+		giDepth++;
+		gcLastCut = is_fd1_point(pstStatus, &stPoint2);
+		giLastDepth = giDepth;
+		answer_gen(pstStatus2);
+		giDepth--;
+		TRACE_EVENT(TRACE_BACK, 0);
+		glWeight /= iOrbit;
+		gcSymMask = cSymMask;
+		gcSymPending = cPending;
+
+		// ΂ׂōs~܂ƕ肪΁A̎܂Ŗ߂
+		if (giSchedCut > giDepth) {
+			giSchedCut = -1;
+		}
+		if (gcStopReason != STOP_NONE || giCutFrame >= 0 || giSchedCut >= 0) {
+			break;
+		}
+
+		// 傫ȕ؂𖳑ʂɂقǌ񂵂ɂ
+		gpppiHistory[(int) stPoint.cRow][(int) stPoint.cCol][pstDir - gpstDirections] += giNodeCases - iNodeCases;
+
+		cTried |= cDirBit;
+		giResumeDepth = -1;
+	}
+
+	gstArena.iTop = iArenaTop;
+
+	if (iFrame >= 0) {
+
+		// ŏ̃O[v͈xȂ
+		if (
+			gcStopReason == STOP_NONE
+			&& (giCutFrame < 0 || giCutFrame == iFrame)
+			&& gpstFrames[iFrame].iDoneCnt == 0
+			&& cComplete == FLG_ON
+		) {
+			add_nogood(&stFirstKey);
+		}
+
+		pop_frame(iFrame);
+	}
+
+}
+
+static int push_frame(
+	unsigned long long *plGroups,
+	char cGroupCnt
+) {
+
+	pGROUP_FRAME pstFrame;
+
+	pstFrame = &gpstFrames[giFrameCnt];
+	memcpy(pstFrame->plGroups, plGroups, sizeof(unsigned long long) * cGroupCnt);
+	pstFrame->cGroupCnt = cGroupCnt;
+	pstFrame->cCurrent = 0;
+	pstFrame->lSavedFocus = glFocusParts;
+	pstFrame->iParent = giActiveFrame;
+	pstFrame->iDoneCnt = 0;
+
+	giActiveFrame = giFrameCnt;
+	glFocusParts = pstFrame->plGroups[0];
+
+	return giFrameCnt++;
+}
+
+static void pop_frame(
+	int iFrame
+) {
+
+	pGROUP_FRAME pstFrame;
+
+	pstFrame = &gpstFrames[iFrame];
+	giActiveFrame = pstFrame->iParent;
+	glFocusParts = pstFrame->lSavedFocus;
+	giFrameCnt = iFrame;
+
+	// ̃t[ŉȂƕ
+	if (giCutFrame == iFrame) {
+		giCutFrame = -1;
+	}
+}
+
+static void next_group(
+	pSTATUS pstStatus
+) {
+
+	pGROUP_FRAME pstFrame;
+	NOGOOD stKey;
+	long iDoneCnt;
+	char cComplete;
+	int iFrame;
+
+	// O[vɎgꂸɎc}X΁ÃO[v̉ł͂Ȃ
+	if (check_partition(pstStatus, NULL, NULL) != RET_OK) {
+		PRUNE_EVENT(gcPruneReason);
+		return;
+	}
+
+	iFrame = giActiveFrame;
+	pstFrame = &gpstFrames[iFrame];
+	pstFrame->iDoneCnt++;
+
+	// qvZX͎󂯎O[vƂŕԂ
+	if (gcGroupChild == FLG_ON && pstFrame->iParent < 0) {
+		memcpy(&gstSolution, pstStatus, sizeof(STATUS));
+		gcStopReason = STOP_SOLVED;
+		return;
+	}
+
+	if (pstFrame->cCurrent + 1 < pstFrame->cGroupCnt) {
+
+		pstFrame->cCurrent++;
+		glFocusParts = pstFrame->plGroups[(int) pstFrame->cCurrent];
+
+		// OɉȂO[vƓ`Ȃ璲ׂ܂łȂ
+		get_nogood_key(pstStatus, &stKey);
+		iDoneCnt = pstFrame->iDoneCnt;
+		cComplete = (giDepth >= giResumeDepth) ? FLG_ON : FLG_OFF;
+		if (has_nogood(&stKey) == RET_OK) {
+			giNogoodCases++;
+			PRUNE_EVENT(PRUNE_NOGOOD);
+		} else {
+			answer_gen(pstStatus);
+		}
+
+		// c̃O[vȂȂAIO[v蒼Ă
+		if (gcStopReason == STOP_NONE && giCutFrame < 0) {
+			if (pstFrame->iDoneCnt == iDoneCnt && cComplete == FLG_ON) {
+				add_nogood(&stKey);
+			}
+			giGroupCutCases++;
+			giCutFrame = iFrame;
+		}
+
+		pstFrame->cCurrent--;
+		glFocusParts = pstFrame->plGroups[(int) pstFrame->cCurrent];
+
+	} else {
+
+		// SO[vIO̒Tɖ߂
+		giActiveFrame = pstFrame->iParent;
+		glFocusParts = pstFrame->lSavedFocus;
+
+		answer_gen(pstStatus);
+
+		giActiveFrame = iFrame;
+		glFocusParts = pstFrame->plGroups[(int) pstFrame->cCurrent];
+	}
+}
+
+static char is_parallel(
+	unsigned long long *plGroups,
+	char cGroupCnt
+) {
+
+	char cLargeCnt;
+	char c;
+
+	if (giJobs <= 1 || gcGroupChild == FLG_ON) {
+		return RET_NG;
+	}
+
+	// ȃO[v͕ċNق
+	cLargeCnt = 0;
+	for (c = 0; c < cGroupCnt; c++) {
+		if (__builtin_popcountll(plGroups[(int) c]) >= PARALLEL_MIN_PARTS) {
+			cLargeCnt++;
+		}
+	}
+
+	if (cLargeCnt < 2) {
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static void fork_groups(
+	pSTATUS pstStatus,
+	int iFrame
+) {
+
+	pGROUP_FRAME pstFrame;
+	STATUS stMerged;
+	CHILD_RESULT stResult;
+	CHECKPOINT stBase;
+	CHECKPOINT stTotal;
+	NOGOOD stKey;
+	pid_t piPids[MAX_PARTS];
+	int piFds[MAX_PARTS];
+	long *piBase;
+	long *piChild;
+	long *piTotal;
+	char *pcBase;
+	char *pcChild;
+	char *pcMerged;
+	char cGroupCnt;
+	char cStarted;
+	char cDone;
+	char cStopReason;
+	int iCounterCnt;
+	int i;
+
+	pstFrame = &gpstFrames[iFrame];
+	cGroupCnt = pstFrame->cGroupCnt;
+
+	giGroupCases++;
+	get_counters(&stBase);
+	memcpy(&stTotal, &stBase, sizeof(CHECKPOINT));
+	memcpy(&stMerged, pstStatus, sizeof(STATUS));
+	cStopReason = STOP_SOLVED;
+	fflush(stdout);
+
+	cStarted = 0;
+	for (cDone = 0; cDone < cGroupCnt; cDone++) {
+
+		while (cStarted < cGroupCnt && cStarted - cDone < giJobs) {
+			piPids[(int) cStarted] = start_group(pstStatus, iFrame, cStarted, &piFds[(int) cStarted]);
+			cStarted++;
+		}
+
+		if (read_child(piFds[(int) cDone], &stResult) != RET_OK) {
+			cStopReason = gcStopReason;
+			break;
+		}
+
+		// qvZX̐𑫂 (JE^ long ̕)
+		iCounterCnt = (sizeof(CHECKPOINT) - offsetof(CHECKPOINT, iNodeCases)) / sizeof(long);
+		piBase = &(stBase.iNodeCases);
+		piChild = &(stResult.stCounters.iNodeCases);
+		piTotal = &(stTotal.iNodeCases);
+		for (i = 0; i < iCounterCnt; i++) {
+			piTotal[i] += piChild[i] - piBase[i];
+		}
+
+		if (stResult.cStopReason != STOP_SOLVED) {
+			cStopReason = stResult.cStopReason;
+			if (cStopReason == STOP_NONE) {
+				glFocusParts = pstFrame->plGroups[(int) cDone];
+				get_nogood_key(pstStatus, &stKey);
+				add_nogood(&stKey);
+				glFocusParts = pstFrame->plGroups[(int) pstFrame->cCurrent];
+			}
+			break;
+		}
+
+		// O[vƂɕςƂ낾d˂
+		pcBase = (char *) pstStatus;
+		pcChild = (char *) &(stResult.stStatus);
+		pcMerged = (char *) &stMerged;
+		for (i = 0; i < (int) sizeof(STATUS); i++) {
+			if (pcChild[i] != pcBase[i]) {
+				pcMerged[i] = pcChild[i];
+			}
+		}
+	}
+
+	for (i = 0; i < cStarted; i++) {
+		if (i >= cDone) {
+			kill(piPids[i], SIGKILL);
+		}
+		close(piFds[i]);
+		waitpid(piPids[i], NULL, 0);
+	}
+
+	set_counters(&stTotal);
+	giNextCheck = giNodeCases;
+
+	if (cStopReason == STOP_NONE) {
+		giGroupCutCases++;
+		return;
+	}
+
+	if (cStopReason != STOP_SOLVED) {
+		gcStopReason = cStopReason;
+		return;
+	}
+
+	// SO[vÎŊO̒Tɖ߂
+	giActiveFrame = pstFrame->iParent;
+	glFocusParts = pstFrame->lSavedFocus;
+
+	answer_gen(&stMerged);
+
+	giActiveFrame = iFrame;
+	glFocusParts = pstFrame->plGroups[(int) pstFrame->cCurrent];
+}
+
+static pid_t start_group(
+	pSTATUS pstStatus,
+	int iFrame,
+	int iGroup,
+	int *piFd
+) {
+
+	int piPipe[2];
+	pid_t iPid;
+	pGROUP_FRAME pstFrame;
+
+	if (pipe(piPipe) != 0) {
+		*piFd = -1;
+		return -1;
+	}
+
+	iPid = fork();
+	if (iPid != 0) {
+		close(piPipe[1]);
+		*piFd = piPipe[0];
+		return iPid;
+	}
+
+	close(piPipe[0]);
+
+	// 󂯎O[vT
+	gcGroupChild = FLG_ON;
+	gcQuiet = FLG_ON;
+	gpstClient = NULL;
+
+	pstFrame = &gpstFrames[iFrame];
+	pstFrame->cCurrent = iGroup;
+	pstFrame->iParent = -1;
+	glFocusParts = pstFrame->plGroups[iGroup];
+	giActiveFrame = iFrame;
+	giFrameCnt = iFrame + 1;
+
+	answer_gen(pstStatus);
+
+	send_result(piPipe[1]);
+
+	return 0;
+}
+
+static char read_child(
+	int iFd,
+	pCHILD_RESULT pstResult
+) {
+
+	struct pollfd stPoll;
+	char *pcBuf;
+	int iRead;
+	int iLen;
+
+	if (iFd < 0) {
+		return RET_NG;
+	}
+
+	pcBuf = (char *) pstResult;
+	iRead = 0;
+	while (iRead < (int) sizeof(CHILD_RESULT)) {
+
+		// ҂ĂԂ\ZƎm߂
+		stPoll.fd = iFd;
+		stPoll.events = POLLIN;
+		if (poll(&stPoll, 1, PARALLEL_POLL_MSEC) <= 0) {
+			check_limits();
+			if (gcStopReason != STOP_NONE) {
+				return RET_NG;
+			}
+			continue;
+		}
+
+		iLen = read(iFd, pcBuf + iRead, sizeof(CHILD_RESULT) - iRead);
+		if (iLen <= 0) {
+			// ʂԂɏIqvZX
+			return RET_NG;
+		}
+		iRead += iLen;
+	}
+
+	return RET_OK;
+}
+
+static void move_link(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+) {
+
+	POINT stPoint = pstLinkPart->stStart;
+
+	close_stat(pstStatus, &stPoint);
+	set_direction(pstStatus, &stPoint, pstNeighbor->pstDir);
+	open_stat(pstStatus, &(pstNeighbor->stPoint), pstLinkPart->pcLinkName, NULL);
+
+	pstLinkPart->stStart = pstNeighbor->stPoint;
+	close_connected_link(pstStatus, pstLinkPart);
+}
+
+static void move_link_end(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+) {
+
+	POINT stPoint = pstLinkPart->stEnd;
+	char cDir;
+
+	// }Xɂ͏I_֌ĉŁAL΂̃}X猳̏I_֌
+	cDir = ((pstNeighbor->pstDir - gpstDirections) + 2) % NEIGHBOR_CNT;
+	close_stat(pstStatus, &stPoint);
+	open_stat(pstStatus, &(pstNeighbor->stPoint), pstLinkPart->pcLinkName, NULL);
+	set_direction(pstStatus, &(pstNeighbor->stPoint), &gpstDirections[(int) cDir]);
+
+	pstLinkPart->stEnd = pstNeighbor->stPoint;
+	close_connected_link(pstStatus, pstLinkPart);
+}
+
+static long apply_paths(
+	pSTATUS pstStatus
+) {
+
+	pPATH_DEF pstPathDef;
+	pLINK_PART pstLinkPart;
+	pPOINT pstPoint;
+	pPOINT pstTail;
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	long iCells;
+	char cFromEnd;
+	char cFollow;
+
+	iCells = 0;
+
+	for (pstPathDef = gpstPathDefs; HAS_LINK(pstPathDef); pstPathDef++) {
+
+		// oH͒[_AN͂p_n܂Ȃ΂ȂȂ (ׂ荇ĕ͂̂܂܂ǂ)
+		// J̏I_n߂
+		pstPoint = pstPathDef->pstPoints;
+		cFromEnd = FLG_OFF;
+		for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+			if (strcmp(pstLinkPart->pcLinkName, pstPathDef->pcLinkName) != 0) {
+				continue;
+			}
+			if (
+				memcmp(&(pstLinkPart->stStart), pstPoint, sizeof(POINT)) == 0
+				&& (pstLinkPart->cPrev < 0 || pstStatus->pstLinkParts[(int) pstLinkPart->cPrev].cClose == FLG_ON)
+			) {
+				break;
+			}
+			if (
+				pstLinkPart->cClose == FLG_OFF
+				&& memcmp(&(pstLinkPart->stEnd), pstPoint, sizeof(POINT)) == 0
+				&& (pstLinkPart->cNext < 0 || pstStatus->pstLinkParts[(int) pstLinkPart->cNext].cClose == FLG_ON)
+			) {
+				cFromEnd = FLG_ON;
+				break;
+			}
+		}
+
+		if (!HAS_LINK(pstLinkPart)) {
+			printf("path '%s' must start at an open end of the link or a waypoint it has reached, not [%d,%d].\n", pstPathDef->pcLinkName, pstPoint->cRow, pstPoint->cCol);
+			return -1;
+		}
+
+		for (pstPoint++; HAS_POINT(pstPoint); pstPoint++) {
+
+			// ͔΂̒[܂ŏĂ悭Ap_͑̕֐i
+			if (pstLinkPart->cClose == FLG_ON) {
+				if (cFromEnd == FLG_ON) {
+					pstTail = &(pstLinkPart->stStart);
+					cFollow = pstLinkPart->cPrev;
+				} else {
+					pstTail = &(pstLinkPart->stEnd);
+					cFollow = pstLinkPart->cNext;
+				}
+				if (memcmp(pstTail, pstPoint, sizeof(POINT)) != 0) {
+					break;
+				}
+				if (cFollow >= 0) {
+					pstLinkPart = pstStatus->pstLinkParts + cFollow;
+				} else if (HAS_POINT((pstPoint + 1))) {
+					pstPoint++;
+					break;
+				}
+				continue;
+			}
+
+			get_neighbors((cFromEnd == FLG_ON) ? &(pstLinkPart->stEnd) : &(pstLinkPart->stStart), pstNeighbors);
+			for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+				if (memcmp(&(pstNeighbor->stPoint), pstPoint, sizeof(POINT)) == 0) {
+					break;
+				}
+			}
+
+			if (
+				!HAS_NEIGHBOR(pstNeighbor)
+				|| has_stat(pstStatus, pstPoint) == RET_OK
+				|| check_branch(pstStatus, pstPoint, pstLinkPart->pcLinkName) != RET_OK
+			) {
+				break;
+			}
+
+			if (cFromEnd == FLG_ON) {
+				move_link_end(pstStatus, pstLinkPart, pstNeighbor);
+			} else {
+				move_link(pstStatus, pstLinkPart, pstNeighbor);
+			}
+			iCells++;
+		}
+
+		if (HAS_POINT(pstPoint)) {
+			printf("path '%s' can not go on to [%d,%d].\n", pstPathDef->pcLinkName, pstPoint->cRow, pstPoint->cCol);
+			return -1;
+		}
+	}
+
+	DEBUG_PRINTF("\n----- path %ld cells -----\n", iCells);
+	DEBUG_PRINT_GRID(pstStatus);
+
+	return iCells;
+}
+
+static void get_edit_distance(
+	char ppcDist[MAX_SIZE][MAX_SIZE]
+) {
+
+	PATH_DEF stPathDef;
+	pLINK_DEF pstLinkDef;
+	pLINK_DEF pstOldDef;
+	pPOINT pstPoint;
+	pPOINT pstEdit;
+	POINT pstEdits[MAX_SIZE * MAX_SIZE * 2];
+	int iEditCnt;
+	int i;
+	char cRow;
+	char cCol;
+	char cDist;
+
+	iEditCnt = 0;
+
+	// [_ςN̐V[_ƁAoH̃}XύX_Ƃ
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+
+		for (pstOldDef = gstIncrState.pstLinkDefs; HAS_LINK(pstOldDef); pstOldDef++) {
+			if (strcmp(pstOldDef->pcLinkName, pstLinkDef->pcLinkName) == 0) {
+				break;
+			}
+		}
+
+		if (HAS_LINK(pstOldDef) && memcmp(pstOldDef->pstPoints, pstLinkDef->pstPoints, sizeof(pstLinkDef->pstPoints)) == 0) {
+			continue;
+		}
+
+		for (pstPoint = pstLinkDef->pstPoints; HAS_POINT(pstPoint) && iEditCnt < MAX_SIZE * MAX_SIZE * 2; pstPoint++) {
+			pstEdits[iEditCnt++] = *pstPoint;
+		}
+	}
+
+	for (pstOldDef = gstIncrState.pstLinkDefs; HAS_LINK(pstOldDef); pstOldDef++) {
+
+		for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+			if (strcmp(pstOldDef->pcLinkName, pstLinkDef->pcLinkName) == 0) {
+				break;
+			}
+		}
+
+		if (HAS_LINK(pstLinkDef) && memcmp(pstOldDef->pstPoints, pstLinkDef->pstPoints, sizeof(pstLinkDef->pstPoints)) == 0) {
+			continue;
+		}
+
+		if (get_solution_path(&(gstIncrState.stSolution), pstOldDef, &stPathDef) != RET_OK) {
+			continue;
+		}
+
+		for (pstPoint = stPathDef.pstPoints; HAS_POINT(pstPoint) && iEditCnt < MAX_SIZE * MAX_SIZE * 2; pstPoint++) {
+			pstEdits[iEditCnt++] = *pstPoint;
+		}
+	}
+
+	for (cRow = 0; cRow < gcSize; cRow++) {
+		for (cCol = 0; cCol < gcSize; cCol++) {
+
+			ppcDist[(int) cRow][(int) cCol] = gcSize * 2;
+
+			for (i = 0, pstEdit = pstEdits; i < iEditCnt; i++, pstEdit++) {
+				cDist = abs(pstEdit->cRow - cRow);
+				if (cDist < abs(pstEdit->cCol - cCol)) {
+					cDist = abs(pstEdit->cCol - cCol);
+				}
+				if (cDist < ppcDist[(int) cRow][(int) cCol]) {
+					ppcDist[(int) cRow][(int) cCol] = cDist;
+				}
+			}
+		}
+	}
+}
+
+static int add_kept_paths(
+	char ppcDist[MAX_SIZE][MAX_SIZE],
+	int iRadius,
+	pPATH_DEF pstPathDef
+) {
+
+	pLINK_DEF pstLinkDef;
+	pLINK_DEF pstOldDef;
+	pPATH_DEF pstUserDef;
+	pPOINT pstPoint;
+	int iKept;
+
+	iKept = 0;
+
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+
+		for (pstOldDef = gstIncrState.pstLinkDefs; HAS_LINK(pstOldDef); pstOldDef++) {
+			if (strcmp(pstOldDef->pcLinkName, pstLinkDef->pcLinkName) == 0) {
+				break;
+			}
+		}
+
+		if (!HAS_LINK(pstOldDef) || memcmp(pstOldDef->pstPoints, pstLinkDef->pstPoints, sizeof(pstLinkDef->pstPoints)) != 0) {
+			continue;
+		}
+
+		// f[^t@CɌoHꂽN͂ɔC
+		for (pstUserDef = gpstPathDefs; pstUserDef < pstPathDef; pstUserDef++) {
+			if (strcmp(pstUserDef->pcLinkName, pstLinkDef->pcLinkName) == 0) {
+				break;
+			}
+		}
+
+		if (pstUserDef < pstPathDef) {
+			continue;
+		}
+
+		if (get_solution_path(&(gstIncrState.stSolution), pstLinkDef, pstPathDef + iKept) != RET_OK) {
+			continue;
+		}
+
+		for (pstPoint = pstPathDef[iKept].pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			if (ppcDist[(int) pstPoint->cRow][(int) pstPoint->cCol] <= iRadius) {
+				break;
+			}
+		}
+
+		if (HAS_POINT(pstPoint)) {
+			memset(pstPathDef + iKept, '\0', sizeof(PATH_DEF));
+			continue;
+		}
+
+		iKept++;
+	}
+
+	return iKept;
+}
+
+static char get_solution_path(
+	pSTATUS pstStatus,
+	pLINK_DEF pstLinkDef,
+	pPATH_DEF pstPathDef
+) {
+
+	pPOINT pstPoint;
+	pPOINT pstLast;
+	pDIRECTION pstDir;
+	char cDir;
+
+	for (pstLast = pstLinkDef->pstPoints; HAS_POINT((pstLast + 1)); pstLast++);
+
+	memset(pstPathDef, '\0', sizeof(PATH_DEF));
+	strcpy(pstPathDef->pcLinkName, pstLinkDef->pcLinkName);
+	pstPoint = pstPathDef->pstPoints;
+	*pstPoint = pstLinkDef->pstPoints[0];
+
+	// }XɎciތn_I_܂łǂ
+	while (memcmp(pstPoint, pstLast, sizeof(POINT)) != 0) {
+
+		if ((pstPoint - pstPathDef->pstPoints) >= MAX_PATH_POINTS - 1) {
+			return RET_NG;
+		}
+
+		cDir = pstStatus->ppcDirs[(int) pstPoint->cRow][(int) pstPoint->cCol];
+		if (cDir == DIR_NONE) {
+			return RET_NG;
+		}
+
+		pstDir = &gpstDirections[(int) cDir];
+		pstPoint[1].cRow = pstPoint->cRow + pstDir->cRowDelta;
+		pstPoint[1].cCol = pstPoint->cCol + pstDir->cColDelta;
+		pstPoint++;
+	}
+
+	(++pstPoint)->cRow = -1;
+	pstPoint->cCol = -1;
+
+	return RET_OK;
+}
+
+static long presolve(
+	pSTATUS pstStatus
+) {
+
+	char ppcEnds[MAX_SIZE][MAX_SIZE];
+	pLINK_PART pstLinkPart;
+	NEIGHBOR stForced;
+	long iCells;
+	char cChanged;
+
+	iCells = 0;
+
+	// 肪Ɍ܂郊NA܂ȂȂ܂ŐL΂
+	do {
+		cChanged = FLG_OFF;
+
+		memset(ppcEnds, '\0', sizeof(ppcEnds));
+		for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+			if (pstLinkPart->cClose == FLG_OFF) {
+				ppcEnds[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] = FLG_ON;
+				ppcEnds[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] = FLG_ON;
+			}
+		}
+
+		for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+
+			if (pstLinkPart->cClose == FLG_ON) {
+				continue;
+			}
+
+			if (find_forced_move(pstStatus, pstLinkPart, ppcEnds, &stForced) != RET_OK) {
+				continue;
+			}
+
+			ppcEnds[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] = FLG_OFF;
+			move_link(pstStatus, pstLinkPart, &stForced);
+			if (pstLinkPart->cClose == FLG_OFF) {
+				ppcEnds[(int) stForced.stPoint.cRow][(int) stForced.stPoint.cCol] = FLG_ON;
+			} else {
+				ppcEnds[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] = FLG_OFF;
+			}
+
+			iCells++;
+			cChanged = FLG_ON;
+		}
+
+	} while (cChanged == FLG_ON);
+
+	DEBUG_PRINTF("\n----- presolve %ld cells -----\n", iCells);
+	DEBUG_PRINT_GRID(pstStatus);
+
+	return iCells;
+}
+
+static char find_forced_move(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	char ppcEnds[MAX_SIZE][MAX_SIZE],
+	pNEIGHBOR pstForced
+) {
+
+	char ppcReach[MAX_SIZE][MAX_SIZE];
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	NEIGHBOR pstNeighbors2[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	pNEIGHBOR pstNeighbor2;
+	pNEIGHBOR pstCorridor;
+	pNEIGHBOR pstLast;
+	POINT stPoint;
+	char cCandCnt;
+	char cFreeCnt;
+
+	fill_reach(pstStatus, &(pstLinkPart->stEnd), ppcReach);
+
+	get_neighbors(&(pstLinkPart->stStart), pstNeighbors);
+
+	cCandCnt = 0;
+	pstCorridor = NULL;
+	pstLast = NULL;
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+		stPoint = pstNeighbor->stPoint;
+		if (has_stat(pstStatus, &stPoint) == RET_OK) {
+			continue;
+		}
+
+		// ̒[_ւǂ蒅Ȃ}Xɂ͐i߂Ȃ
+		if (ppcReach[(int) stPoint.cRow][(int) stPoint.cCol] == FLG_OFF) {
+			continue;
+		}
+
+		if (check_branch(pstStatus, &stPoint, pstLinkPart->pcLinkName) != RET_OK) {
+			continue;
+		}
+
+		cCandCnt++;
+		pstLast = pstNeighbor;
+
+		// o 2 Ȃ󂫃}X́Aׂ̒[_邵Ȃ
+		// (͑S}X𖄂߂ՖʂȂ̂ŁÃ}X󂯂܂܂ɂ͂łȂ)
+		cFreeCnt = 0;
+		get_neighbors(&stPoint, pstNeighbors2);
+		for (pstNeighbor2 = pstNeighbors2; HAS_NEIGHBOR(pstNeighbor2); pstNeighbor2++) {
+			if (
+				has_stat(pstStatus, &(pstNeighbor2->stPoint)) != RET_OK
+				|| ppcEnds[(int) pstNeighbor2->stPoint.cRow][(int) pstNeighbor2->stPoint.cCol] == FLG_ON
+			) {
+				cFreeCnt++;
+			}
+		}
+
+		if (cFreeCnt == 2) {
+			if (pstCorridor != NULL) {
+				return RET_NG;
+			}
+			pstCorridor = pstNeighbor;
+		}
+	}
+
+	if (pstCorridor != NULL) {
+		*pstForced = *pstCorridor;
+		return RET_OK;
+	}
+
+	if (cCandCnt == 1) {
+		*pstForced = *pstLast;
+		return RET_OK;
+	}
+
+	return RET_NG;
+}
+
+static void fill_reach(
+	pSTATUS pstStatus,
+	pPOINT pstFrom,
+	char ppcReach[MAX_SIZE][MAX_SIZE]
+) {
+
+	POINT pstQueue[MAX_SIZE * MAX_SIZE];
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	POINT stPoint;
+	int iHead;
+	int iTail;
+
+	memset(ppcReach, '\0', sizeof(char) * MAX_SIZE * MAX_SIZE);
+
+	// [_ɗׂ荇}X󂫃}Xǂ
+	iTail = 0;
+	pstQueue[iTail++] = *pstFrom;
+
+	for (iHead = 0; iHead < iTail; iHead++) {
+
+		get_neighbors(&pstQueue[iHead], pstNeighbors);
+
+		for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+			stPoint = pstNeighbor->stPoint;
+			if (ppcReach[(int) stPoint.cRow][(int) stPoint.cCol] == FLG_ON) {
+				continue;
+			}
+			if (has_stat(pstStatus, &stPoint) == RET_OK) {
+				continue;
+			}
+
+			ppcReach[(int) stPoint.cRow][(int) stPoint.cCol] = FLG_ON;
+			pstQueue[iTail++] = stPoint;
+		}
+	}
+}
+
+static void send_result(
+	int iFd
+) {
+
+	CHILD_RESULT stResult;
+
+	get_child_result(&stResult);
+
+	write(iFd, &stResult, sizeof(stResult));
+	close(iFd);
+	_exit(EXIT_SUCCESS);
+}
+
+static void get_child_result(
+	pCHILD_RESULT pstResult
+) {
+
+	memset(pstResult, '\0', sizeof(CHILD_RESULT));
+	pstResult->cStopReason = gcStopReason;
+	memcpy(&(pstResult->stStatus), &gstSolution, sizeof(STATUS));
+	get_counters(&(pstResult->stCounters));
+	pstResult->iSolutionCases = giSolutionCases;
+}
+
+static void search(
+	pSTATUS pstStatus
+) {
+
+	if (giPortfolio > 1) {
+		run_portfolio(pstStatus);
+		return;
+	}
+
+	if (giDistribute > 1) {
+		run_distributed(pstStatus);
+		return;
+	}
+
+	run_restarts(pstStatus);
+}
+
+static void run_restarts(
+	pSTATUS pstStatus
+) {
+
+	int iRun;
+
+	for (iRun = 0; ; iRun++) {
+
+		set_part_order(pstStatus, iRun);
+
+		if (gcRestart != RESTART_NONE) {
+			giRestartLimit = giNodeCases + get_restart_budget(iRun);
+			if (giNextCheck > giRestartLimit) {
+				giNextCheck = giRestartLimit;
+			}
+		}
+
+		// ĎnƂɍ̔ՖʂL^
+		if (gpstTraceFile != NULL) {
+			add_trace_root(pstStatus);
+		}
+		giRootFilled = get_filled(pstStatus);
+		answer_gen(pstStatus);
+
+		if (gcStopReason != STOP_RESTART) {
+			break;
+		}
+
+		// Ȃ̂ŁAosčŏ蒼
+		giRestartCases++;
+		gcStopReason = STOP_NONE;
+		if (gcQuiet == FLG_OFF) {
+			printf("\nrestart:%ld, nodes:%ld\n", giRestartCases, giNodeCases);
+		}
+	}
+
+	giRestartLimit = 0;
+}
+
+static long get_restart_budget(
+	int iRun
+) {
+
+	long iBudget;
+	int iSize;
+	int i;
+
+	iBudget = giRestartBase;
+
+	if (gcRestart == RESTART_GEOMETRIC) {
+		for (i = 0; i < iRun && iBudget < LONG_MAX / 2; i++) {
+			iBudget += iBudget / 2;
+		}
+		return iBudget;
+	}
+
+	// Luby  1, 1, 2, 1, 1, 2, 4, 1, ...
+	iRun++;
+	for (;;) {
+		for (iSize = 1; iSize < iRun; iSize = iSize * 2 + 1);
+		if (iSize == iRun) {
+			break;
+		}
+		iRun -= iSize / 2;
+	}
+
+	return iBudget * ((iSize + 1) / 2);
+}
+
+static void run_portfolio(
+	pSTATUS pstStatus
+) {
+
+	struct pollfd pstPolls[MAX_PORTFOLIO];
+	pid_t piPids[MAX_PORTFOLIO];
+	CHILD_RESULT stResult;
+	char cStopReason;
+	int iAlive;
+	int i;
+
+	fflush(stdout);
+	for (i = 0; i < giPortfolio; i++) {
+		piPids[i] = start_strategy(pstStatus, i, &(pstPolls[i].fd));
+		pstPolls[i].events = POLLIN;
+	}
+
+	// ŏɌ헪̌ʂ̂Ac͎~߂
+	cStopReason = STOP_CANCEL;
+	iAlive = giPortfolio;
+	while (iAlive > 0) {
+
+		if (poll(pstPolls, giPortfolio, PARALLEL_POLL_MSEC) <= 0) {
+			// \Z͊e헪Ő̂ŁAł͎
+			check_limits();
+			if (gcStopReason == STOP_CANCEL) {
+				break;
+			}
+			gcStopReason = STOP_NONE;
+			continue;
+		}
+
+		for (i = 0; i < giPortfolio; i++) {
+
+			if (pstPolls[i].fd < 0 || pstPolls[i].revents == 0) {
+				continue;
+			}
+
+			if (read_child(pstPolls[i].fd, &stResult) == RET_OK) {
+				if (stResult.cStopReason == STOP_SOLVED || stResult.cStopReason == STOP_NONE) {
+					gcStopReason = stResult.cStopReason;
+					memcpy(&gstSolution, &(stResult.stStatus), sizeof(STATUS));
+					set_counters(&(stResult.stCounters));
+					break;
+				}
+				cStopReason = stResult.cStopReason;
+				set_counters(&(stResult.stCounters));
+			}
+
+			close(pstPolls[i].fd);
+			pstPolls[i].fd = -1;
+			iAlive--;
+		}
+
+		if (gcStopReason != STOP_NONE || i < giPortfolio) {
+			break;
+		}
+	}
+
+	for (i = 0; i < giPortfolio; i++) {
+		kill(piPids[i], SIGKILL);
+		if (pstPolls[i].fd >= 0) {
+			close(pstPolls[i].fd);
+		}
+		waitpid(piPids[i], NULL, 0);
+	}
+
+	// ǂ̐헪Ȃ
+	if (iAlive <= 0 && gcStopReason == STOP_NONE) {
+		gcStopReason = cStopReason;
+	}
+}
+
+static pid_t start_strategy(
+	pSTATUS pstStatus,
+	int iStrategy,
+	int *piFd
+) {
+
+	int piPipe[2];
+	pid_t iPid;
+
+	if (pipe(piPipe) != 0) {
+		*piFd = -1;
+		return -1;
+	}
+
+	iPid = fork();
+	if (iPid != 0) {
+		close(piPipe[1]);
+		*piFd = piPipe[0];
+		return iPid;
+	}
+
+	close(piPipe[0]);
+
+	gcQuiet = FLG_ON;
+	gpstClient = NULL;
+	giJobs = 1;
+	giPortfolio = 1;
+
+	// 0 Ԃ͎wǂAق͎ςčĎn݂̕Ɏg
+	if (iStrategy > 0) {
+		gcRandomize = FLG_ON;
+		glSeed += iStrategy;
+		if (gcRestart == RESTART_NONE) {
+			gcRestart = (iStrategy % 2 == 1) ? RESTART_LUBY : RESTART_GEOMETRIC;
+		}
+	}
+
+	run_restarts(pstStatus);
+
+	send_result(piPipe[1]);
+
+	return 0;
+}
+
+static void run_distributed(
+	pSTATUS pstStatus
+) {
+
+	struct pollfd pstPolls[MAX_DIST];
+	pid_t piPids[MAX_DIST];
+	CHECKPOINT pstLast[MAX_DIST];
+	long piLastSolutions[MAX_DIST];
+	char pcBusy[MAX_DIST];
+	CHILD_RESULT stResult;
+	CHECKPOINT stTotal;
+	long iMaxNodes;
+	long iNext;
+	int iWorkers;
+	int iBusy;
+	int i;
+
+	set_part_order(pstStatus, 0);
+
+	// [܂ł͎ŒTLA؂̍܂ł̎菇W߂
+	giTaskLen = 0;
+	giTaskCnt = 0;
+	gcSplit = FLG_ON;
+	answer_gen(pstStatus);
+	gcSplit = FLG_OFF;
+
+	if (gcStopReason != STOP_NONE || giTaskCnt == 0) {
+		return;
+	}
+
+	iWorkers = (giTaskCnt < giDistribute) ? giTaskCnt : giDistribute;
+	if (gcQuiet == FLG_OFF) {
+		printf("\ndistribute:%d tasks, %d workers\n", giTaskCnt, iWorkers);
+	}
+	fflush(stdout);
+
+	// ߓ_̗\Z͎c[J[ɓ
+	iMaxNodes = giMaxNodes;
+	if (giMaxNodes > 0) {
+		giMaxNodes = giNodeCases + (giMaxNodes - giNodeCases + iWorkers - 1) / iWorkers;
+	}
+
+	get_counters(&stTotal);
+	iNext = 0;
+	iBusy = 0;
+	for (i = 0; i < iWorkers; i++) {
+		piPids[i] = start_dist_worker(pstStatus, pstPolls, i);
+		pstPolls[i].events = POLLIN;
+		memcpy(&pstLast[i], &stTotal, sizeof(CHECKPOINT));
+		piLastSolutions[i] = giSolutionCases;
+		pcBusy[i] = FLG_OFF;
+		if (send_task(pstPolls[i].fd, &iNext) == RET_OK) {
+			pcBusy[i] = FLG_ON;
+			iBusy++;
+		}
+	}
+	giMaxNodes = iMaxNodes;
+
+	// 󂢂[J[珇Ɏ̕؂n
+	while (iBusy > 0 && gcStopReason == STOP_NONE) {
+
+		if (poll(pstPolls, iWorkers, PARALLEL_POLL_MSEC) <= 0) {
+			check_limits();
+			continue;
+		}
+
+		for (i = 0; i < iWorkers && gcStopReason == STOP_NONE; i++) {
+
+			if (pstPolls[i].fd < 0 || pstPolls[i].revents == 0) {
+				continue;
+			}
+
+			if (read_child(pstPolls[i].fd, &stResult) != RET_OK) {
+				// ʂԂɏI[J[̕؂ׂ͒ĂȂ
+				if (gcStopReason == STOP_NONE) {
+					gcStopReason = STOP_CANCEL;
+				}
+				break;
+			}
+
+			pcBusy[i] = FLG_OFF;
+			merge_dist_result(&stResult, &pstLast[i], &piLastSolutions[i], &stTotal);
+
+			if (stResult.cStopReason != STOP_NONE) {
+				if (stResult.cStopReason == STOP_SOLVED) {
+					memcpy(&gstSolution, &(stResult.stStatus), sizeof(STATUS));
+				}
+				gcStopReason = stResult.cStopReason;
+				break;
+			}
+
+			if (send_task(pstPolls[i].fd, &iNext) == RET_OK) {
+				pcBusy[i] = FLG_ON;
+			} else {
+				close(pstPolls[i].fd);
+				pstPolls[i].fd = -1;
+				iBusy--;
+			}
+		}
+
+		// \Z͑S[J[킹Ŋm߂
+		if (gcStopReason == STOP_NONE) {
+			check_limits();
+		}
+	}
+
+	// 邩\Zsc̃[J[~߁A܂łɐ󂯎
+	for (i = 0; i < iWorkers; i++) {
+		if (pcBusy[i] == FLG_ON) {
+			kill(piPids[i], SIGTERM);
+		}
+	}
+
+	for (i = 0; i < iWorkers; i++) {
+		if (pcBusy[i] == FLG_ON && read_dist_result(pstPolls[i].fd, &stResult) == RET_OK) {
+			merge_dist_result(&stResult, &pstLast[i], &piLastSolutions[i], &stTotal);
+		}
+		kill(piPids[i], SIGKILL);
+		if (pstPolls[i].fd >= 0) {
+			close(pstPolls[i].fd);
+		}
+		waitpid(piPids[i], NULL, 0);
+	}
+
+	set_counters(&stTotal);
+	giNextCheck = giNodeCases;
+}
+
+static void merge_dist_result(
+	pCHILD_RESULT pstResult,
+	pCHECKPOINT pstLast,
+	long *piLastSolutions,
+	pCHECKPOINT pstTotal
+) {
+
+	long *piLast;
+	long *piChild;
+	long *piTotal;
+	int iCounterCnt;
+	int i;
+
+	// [J[̃JE^͑OɎ󂯎Ƃ̍𑫂 (JE^ long ̕)
+	iCounterCnt = (sizeof(CHECKPOINT) - offsetof(CHECKPOINT, iNodeCases)) / sizeof(long);
+	piLast = &(pstLast->iNodeCases);
+	piChild = &(pstResult->stCounters.iNodeCases);
+	piTotal = &(pstTotal->iNodeCases);
+	for (i = 0; i < iCounterCnt; i++) {
+		piTotal[i] += piChild[i] - piLast[i];
+	}
+	memcpy(pstLast, &(pstResult->stCounters), sizeof(CHECKPOINT));
+	set_counters(pstTotal);
+
+	if (pstResult->iSolutionCases > *piLastSolutions) {
+		if (giSolutionCases == 0) {
+			memcpy(&gstSolution, &(pstResult->stStatus), sizeof(STATUS));
+		}
+		giSolutionCases += pstResult->iSolutionCases - *piLastSolutions;
+		*piLastSolutions = pstResult->iSolutionCases;
+	}
+}
+
+static char read_dist_result(
+	int iFd,
+	pCHILD_RESULT pstResult
+) {
+
+	struct pollfd stPoll;
+	char *pcBuf;
+	int iRead;
+	int iLen;
+
+	// ~߂[J[͎ƂĕԂ̂ŁA΂炭҂
+	pcBuf = (char *) pstResult;
+	for (iRead = 0; iRead < (int) sizeof(CHILD_RESULT); iRead += iLen) {
+		stPoll.fd = iFd;
+		stPoll.events = POLLIN;
+		if (poll(&stPoll, 1, DIST_STOP_MSEC) <= 0) {
+			return RET_NG;
+		}
+		iLen = read(iFd, pcBuf + iRead, sizeof(CHILD_RESULT) - iRead);
+		if (iLen <= 0) {
+			return RET_NG;
+		}
+	}
+
+	return RET_OK;
+}
+
+static void add_task(void) {
+
+	// 菇͒ 1 oCgƐ[Ƃ̎l߂ĕׂ
+	if (giTaskLen + giDepth + 1 > giTaskCap) {
+		giTaskCap += DIST_TASK_STEP;
+		gpbTasks = realloc(gpbTasks, giTaskCap);
+	}
+
+	gpbTasks[giTaskLen++] = giDepth;
+	memcpy(gpbTasks + giTaskLen, gpcMoves, giDepth);
+	giTaskLen += giDepth;
+	giTaskCnt++;
+
+	// ̃m[h̓[J[
+	giNodeCases--;
+}
+
+static char send_task(
+	int iFd,
+	long *piNext
+) {
+
+	int iLen;
+
+	if (iFd < 0 || *piNext >= giTaskLen) {
+		return RET_NG;
+	}
+
+	iLen = gpbTasks[*piNext] + 1;
+	if (write(iFd, gpbTasks + *piNext, iLen) != iLen) {
+		return RET_NG;
+	}
+	*piNext += iLen;
+
+	return RET_OK;
+}
+
+static pid_t start_dist_worker(
+	pSTATUS pstStatus,
+	struct pollfd *pstPolls,
+	int iWorker
+) {
+
+	CHILD_RESULT stResult;
+	int piSocks[2];
+	pid_t iPid;
+	char cSymMask;
+	int i;
+
+	if (socketpair(AF_UNIX, SOCK_STREAM, 0, piSocks) != 0) {
+		pstPolls[iWorker].fd = -1;
+		return -1;
+	}
+
+	iPid = fork();
+	if (iPid != 0) {
+		close(piSocks[1]);
+		pstPolls[iWorker].fd = piSocks[0];
+		return iPid;
+	}
+
+	// ɋN[J[ւ̌ĂƁAĂɓ`Ȃ
+	close(piSocks[0]);
+	for (i = 0; i < iWorker; i++) {
+		if (pstPolls[i].fd >= 0) {
+			close(pstPolls[i].fd);
+		}
+	}
+
+	gcQuiet = FLG_ON;
+	gpstClient = NULL;
+	cSymMask = gcSymMask;
+
+	// zꂽ菇ǂāA̕؂TĕԂ
+	while (read_task(piSocks[1]) == RET_OK) {
+
+		reset_search();
+		giResumeDepth = giTaskDepth;
+		glWeight = 1;
+		gcSymMask = cSymMask;
+		gcSymPending = FLG_OFF;
+
+		answer_gen(pstStatus);
+
+		get_child_result(&stResult);
+		if (write(piSocks[1], &stResult, sizeof(stResult)) != sizeof(stResult)) {
+			break;
+		}
+	}
+
+	close(piSocks[1]);
+	_exit(EXIT_SUCCESS);
+
+	return 0;
+}
+
+static char read_task(
+	int iFd
+) {
+
+	unsigned char bLen;
+	int iRead;
+	int iLen;
+
+	if (read(iFd, &bLen, 1) != 1) {
+		return RET_NG;
+	}
+
+	for (iRead = 0; iRead < bLen; iRead += iLen) {
+		iLen = read(iFd, gpcMoves + iRead, bLen - iRead);
+		if (iLen <= 0) {
+			return RET_NG;
+		}
+	}
+	giTaskDepth = bLen;
+
+	return RET_OK;
+}
+
+static void set_part_order(
+	pSTATUS pstStatus,
+	int iRun
+) {
+
+	pLINK_PART pstLinkPart;
+	char cTemp;
+	int i;
+	int j;
+
+	gcPartCnt = 0;
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		gpcPartOrder[(int) gcPartCnt] = gcPartCnt;
+		gcPartCnt++;
+	}
+
+	if (gcRandomize == FLG_OFF) {
+		return;
+	}
+
+	glRandom = mix_key(glSeed * MAX_DEPTH + iRun);
+	if (glRandom == 0) {
+		glRandom = 1;
+	}
+
+	for (i = gcPartCnt - 1; i > 0; i--) {
+		j = get_random(i + 1);
+		cTemp = gpcPartOrder[i];
+		gpcPartOrder[i] = gpcPartOrder[j];
+		gpcPartOrder[j] = cTemp;
+	}
+}
+
+static void shuffle_neighbors(
+	pNEIGHBOR pstNeighbors
+) {
+
+	NEIGHBOR stTemp;
+	int iCnt;
+	int i;
+	int j;
+
+	for (iCnt = 0; HAS_NEIGHBOR((pstNeighbors + iCnt)); iCnt++);
+
+	for (i = iCnt - 1; i > 0; i--) {
+		j = get_random(i + 1);
+		stTemp = pstNeighbors[i];
+		pstNeighbors[i] = pstNeighbors[j];
+		pstNeighbors[j] = stTemp;
+	}
+}
+
+static void put_first_neighbor(
+	pNEIGHBOR pstNeighbors,
+	char cDir
+) {
+
+	NEIGHBOR stTemp;
+	int i;
+
+	for (i = 0; HAS_NEIGHBOR((pstNeighbors + i)); i++) {
+		if (pstNeighbors[i].pstDir - gpstDirections == cDir) {
+			break;
+		}
+	}
+	if (!HAS_NEIGHBOR((pstNeighbors + i))) {
+		return;
+	}
+
+	// ق̕̕т͕ɑO֊񂹂
+	stTemp = pstNeighbors[i];
+	for (; i > 0; i--) {
+		pstNeighbors[i] = pstNeighbors[i - 1];
+	}
+	pstNeighbors[0] = stTemp;
+}
+
+static void order_neighbors(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbors
+) {
+
+	NEIGHBOR stTemp;
+	long piScores[NEIGHBOR_CNT];
+	long iScore;
+	int iCnt;
+	int i;
+	int j;
+
+	for (iCnt = 0; HAS_NEIGHBOR((pstNeighbors + iCnt)); iCnt++) {
+		piScores[iCnt] = get_order_score(pstStatus, pstLinkPart, pstNeighbors + iCnt);
+	}
+
+	// _̏ɕׂ (_͌̏̂܂)
+	for (i = 1; i < iCnt; i++) {
+		stTemp = pstNeighbors[i];
+		iScore = piScores[i];
+		for (j = i; j > 0 && piScores[j - 1] > iScore; j--) {
+			pstNeighbors[j] = pstNeighbors[j - 1];
+			piScores[j] = piScores[j - 1];
+		}
+		pstNeighbors[j] = stTemp;
+		piScores[j] = iScore;
+	}
+}
+
+static long get_order_score(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	pNEIGHBOR pstNeighbor
+) {
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor2;
+	POINT stPoint;
+	POINT stFrom;
+	long iScore;
+	int iEdge;
+
+	stPoint = pstNeighbor->stPoint;
+	stFrom = pstLinkPart->stStart;
+
+	switch (gcOrder) {
+	case ORDER_PARTNER:
+		// ̒[_ɋ߂Â肩
+		return abs(stPoint.cRow - pstLinkPart->stEnd.cRow) + abs(stPoint.cCol - pstLinkPart->stEnd.cCol);
+
+	case ORDER_WALL:
+		// Ղ̒[ɋ߂Aӂӂ̑}X
+		iEdge = stPoint.cRow;
+		if (gcSize - 1 - stPoint.cRow < iEdge) {
+			iEdge = gcSize - 1 - stPoint.cRow;
+		}
+		if (stPoint.cCol < iEdge) {
+			iEdge = stPoint.cCol;
+		}
+		if (gcSize - 1 - stPoint.cCol < iEdge) {
+			iEdge = gcSize - 1 - stPoint.cCol;
+		}
+		iScore = iEdge * (NEIGHBOR_CNT + 1);
+		get_neighbors(&stPoint, pstNeighbors);
+		for (pstNeighbor2 = pstNeighbors; HAS_NEIGHBOR(pstNeighbor2); pstNeighbor2++) {
+			if (has_stat(pstStatus, &(pstNeighbor2->stPoint)) != RET_OK) {
+				iScore++;
+			}
+		}
+		return iScore;
+
+	case ORDER_EXITS:
+		// ̏oȂ}X
+		iScore = 0;
+		get_neighbors(&stPoint, pstNeighbors);
+		for (pstNeighbor2 = pstNeighbors; HAS_NEIGHBOR(pstNeighbor2); pstNeighbor2++) {
+			if (has_stat(pstStatus, &(pstNeighbor2->stPoint)) != RET_OK) {
+				iScore++;
+			}
+		}
+		return iScore;
+
+	case ORDER_HISTORY:
+		return gpppiHistory[(int) stFrom.cRow][(int) stFrom.cCol][pstNeighbor->pstDir - gpstDirections];
+
+	default:
+		return 0;
+	}
+}
+
+static unsigned long get_random(
+	unsigned long lRange
+) {
+
+	glRandom ^= glRandom >> 12;
+	glRandom ^= glRandom << 25;
+	glRandom ^= glRandom >> 27;
+
+	return (unsigned long) ((glRandom * 0x2545f4914f6cdd1dULL) >> 33) % lRange;
+}
+
+static char check_branch(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	char *pcLinkName
+) {
+
+	char pcClosedStat[STAT_LEN + 1];
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	char *pcStat;
+
+	make_stat(pcClosedStat, pcLinkName, CLOSE_MARK);
+
+	get_neighbors(pstPoint, pstNeighbors);
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+
+		if (strcmp(pcStat, pcClosedStat) == 0) {
+			giBranchErrCases++;
+			gcPruneReason = PRUNE_BRANCH;
+			DEBUG_PRINTF("\n----- branch of '%s' at [%d, %d] -----\n", pcLinkName, pstPoint->cRow, pstPoint->cCol);
+			DEBUG_PRINT_GRID(pstStatus);
+			return RET_NG;
+		}
+	}
+
+	return RET_OK;
+}
+
+static char run_checks(
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char *pcGroupCnt
+) {
+
+	double dStart;
+	char cCutProne;
+	char cRet;
+
+	if (gcProfile == FLG_OFF && gcSchedule == FLG_OFF) {
+		if (
+			check_partition(pstStatus, plGroups, pcGroupCnt) != RET_OK
+			|| check_reachable(pstStatus) != RET_OK
+			|| check_forward1(pstStatus) != RET_OK
+		) {
+			return RET_NG;
+		}
+		return RET_OK;
+	}
+
+	// ԈƂ́AO̎肪ڂɂȂ肻ȃ}XɐGĂΕKׂ
+	*pcGroupCnt = 1;
+	cCutProne = RET_OK;
+	if (gcSchedule == FLG_ON) {
+		cCutProne = is_cut_prone();
+		gppstSchedPath[giDepth] = pstStatus;
+		gpcSchedSkipped[giDepth] = 0;
+		if (giDepth <= giSchedCut) {
+			giSchedCut = -1;
+		}
+	}
+
+	if (is_check_due(SCHED_PARTITION, cCutProne) == RET_OK) {
+		dStart = get_clock();
+		cRet = check_partition(pstStatus, plGroups, pcGroupCnt);
+		add_check_stat(SCHED_PARTITION, (long) ((get_clock() - dStart) * 1e9), cRet);
+		if (cRet != RET_OK) {
+			return RET_NG;
+		}
+	}
+
+	if (check_reachable(pstStatus) != RET_OK) {
+		return RET_NG;
+	}
+
+	// ŊO[ł forward-1 Ȃ (}肪邾ŉ͕ςȂ)
+	if (gpcFd1Off[giDepth] == FLG_ON || is_check_due(SCHED_FORWARD1, cCutProne) != RET_OK) {
+		return RET_OK;
+	}
+
+	dStart = get_clock();
+	cRet = check_forward1(pstStatus);
+	add_check_stat(SCHED_FORWARD1, (long) ((get_clock() - dStart) * 1e9), cRet);
+
+	if (gcAutoTune == FLG_ON && gpstDepthBins[giDepth].iForward1Calls == TUNE_MIN_CALLS) {
+		tune_forward1(giDepth);
+	}
+
+	return cRet;
+}
+
+static char is_cut_prone(void) {
+
+	// i߂ēm[hłȂ΁AǂςȂ
+	if (giLastDepth != giDepth) {
+		return RET_OK;
+	}
+	giLastDepth = -1;
+
+	// ߂Ƌ󂫃}X}X (fd1) 𖄂߂̂Ƃ؂ڂł
+	return gcLastCut;
+}
+
+static char is_check_due(
+	char cCheck,
+	char cCutProne
+) {
+
+	pSCHED_STAT pstStat;
+
+	if (gcSchedule == FLG_OFF || cCutProne == RET_OK) {
+		return RET_OK;
+	}
+
+	// ܂ł͖񒲂ׁÂƂ͌߂Ԋu΂
+	pstStat = &gppstSchedStats[giDepth][(int) cCheck];
+	if (pstStat->iCalls < TUNE_MIN_CALLS || pstStat->iWait <= 0) {
+		return RET_OK;
+	}
+
+	pstStat->iWait--;
+	gplSchedSkips[(int) cCheck]++;
+	gpcSchedSkipped[giDepth] |= 1 << cCheck;
+	return RET_NG;
+}
+
+static char check_skipped(
+	int iDepthEnd
+) {
+
+	int iDepth;
+
+	// 󂢂قm߁AʂȂ΂܂Ŗ߂悤 giSchedCut Ɏc
+	for (iDepth = 0; iDepth < iDepthEnd; iDepth++) {
+		if (
+			(gpcSchedSkipped[iDepth] & (1 << SCHED_PARTITION)) != 0
+			&& check_partition(gppstSchedPath[iDepth], NULL, NULL) != RET_OK
+		) {
+			giSchedCut = iDepth;
+			return RET_NG;
+		}
+		if (
+			(gpcSchedSkipped[iDepth] & (1 << SCHED_FORWARD1)) != 0
+			&& check_forward1(gppstSchedPath[iDepth]) != RET_OK
+		) {
+			giSchedCut = iDepth;
+			return RET_NG;
+		}
+		gpcSchedSkipped[iDepth] = 0;
+	}
+
+	return RET_OK;
+}
+
+static void add_check_stat(
+	char cCheck,
+	long iNsec,
+	char cRet
+) {
+
+	pPROFILE_BIN pstDepthBin;
+	pPROFILE_BIN pstFillBin;
+	pSCHED_STAT pstStat;
+	long iNodeNsec;
+	long iInterval;
+
+	if (gcProfile == FLG_ON) {
+		pstDepthBin = &gpstDepthBins[giDepth];
+		pstFillBin = get_fill_bin();
+		if (cCheck == SCHED_PARTITION) {
+			pstDepthBin->iPartitionNsec += iNsec;
+			pstFillBin->iPartitionNsec += iNsec;
+		} else {
+			pstDepthBin->iForward1Nsec += iNsec;
+			pstFillBin->iForward1Nsec += iNsec;
+			pstDepthBin->iForward1Calls++;
+			pstFillBin->iForward1Calls++;
+			if (cRet != RET_OK) {
+				pstDepthBin->iForward1Prunes++;
+				pstFillBin->iForward1Prunes++;
+			}
+		}
+	}
+
+	if (gcSchedule == FLG_OFF) {
+		return;
+	}
+
+	pstStat = &gppstSchedStats[giDepth][(int) cCheck];
+	pstStat->iCalls++;
+	pstStat->iNsec += iNsec;
+	if (cRet != RET_OK) {
+		pstStat->iPrunes++;
+	}
+
+	// TiނƓς̂ŁAÂ͔Y
+	if (pstStat->iCalls >= SCHED_WINDOW) {
+		pstStat->iCalls /= 2;
+		pstStat->iPrunes /= 2;
+		pstStat->iNsec /= 2;
+	}
+
+	// Ƃ}ЂƂ partition m[hȂƂ݂āA
+	// ׂ̏dɌ܂ŊԂ󂯂
+	pstStat = gppstSchedStats[giDepth];
+	iNodeNsec = pstStat[SCHED_PARTITION].iNsec / (pstStat[SCHED_PARTITION].iCalls + 1) + 1;
+	pstStat += cCheck;
+	if (pstStat->iPrunes == 0) {
+		iInterval = SCHED_MAX_INTERVAL;
+	} else {
+		iInterval = pstStat->iNsec / (pstStat->iPrunes * TUNE_SAVED_NODES * iNodeNsec);
+	}
+	if (iInterval < 1) {
+		iInterval = 1;
+	} else if (iInterval > SCHED_MAX_INTERVAL) {
+		iInterval = SCHED_MAX_INTERVAL;
+	}
+	pstStat->iWait = (int) iInterval - 1;
+}
+
+static char check_partition(
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char *pcGroupCnt
+) {
+
+	pSTATUS pstStatus2;
+	POINT stPoint;
+	char (*ppcExitPoints)[MAX_SIZE];
+	char cPartActive;
+	pLINK_PART pstLinkPart;
+
+	int piColorCnts[2];
+	int *piColorDiffs;
+	unsigned long long *plActiveParts;
+	char pcActiveCnts[MAX_PARTS + 1];
+	int iRegionCnt;
+	int iRegion;
+	int iPart;
+	int iFixed;
+	int iLower;
+	int iUpper;
+	char cParity;
+
+	// ʂƓh蕪ɂ͒חp̍Ɨ̈g (ׂǂ͓qɂȂȂ)
+	pstStatus2 = &(gpstProbe->stStatus);
+	ppcExitPoints = gpstProbe->ppcExitPoints;
+	piColorDiffs = gpstProbe->piColorDiffs;
+	plActiveParts = gpstProbe->plActiveParts;
+
+	memcpy(pstStatus2, pstStatus, sizeof(STATUS));
+	memset(pcActiveCnts, '\0', sizeof(pcActiveCnts));
+	iRegionCnt = 0;
+
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			if (has_stat(pstStatus2, &stPoint) == RET_OK) {
+				continue;
+			}
+
+			memset(ppcExitPoints, '\0', sizeof(gpstProbe->ppcExitPoints));
+			piColorCnts[0] = 0;
+			piColorCnts[1] = 0;
+			if (fill_partition(pstStatus2, &stPoint, ppcExitPoints, piColorCnts) != RET_OK) {
+				return RET_NG;
+			}
+
+			cPartActive = FLG_OFF;
+			piColorDiffs[iRegionCnt] = piColorCnts[0] - piColorCnts[1];
+			plActiveParts[iRegionCnt] = 0;
+
+			for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+				if (pstLinkPart->cClose == FLG_ON) {
+					continue;
+				}
+				if (ppcExitPoints[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] != FLG_ON) {
+					continue;
+				}
+				if (ppcExitPoints[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] != FLG_ON) {
+					continue;
+				}
+				cPartActive = FLG_ON;
+				iPart = pstLinkPart - pstStatus->pstLinkParts;
+				pstStatus2->pstLinkParts[iPart].cClose = FLG_ON;
+				plActiveParts[iRegionCnt] |= 1ULL << iPart;
+				pcActiveCnts[iPart]++;
+
+			}
+			iRegionCnt++;
+
+//			DEBUG_PRINTF("  fill : [%d, %d], exit : ", stPoint.cRow, stPoint.cCol);
+//			DEBUG_PRINT_EXIT(ppcExitPoints);
+//			DEBUG_PRINTF(" active : %d\n", cPartActive);
+
+			// NȂV}
+			if (cPartActive != FLG_ON) {
+				giDeadPartitionCases++;
+				gcPruneReason = PRUNE_DEAD_PARTITION;
+				DEBUG_PRINTF("\n----- dead partition at [%d, %d] -----\n", stPoint.cRow, stPoint.cCol);
+				DEBUG_PRINT_GRID(pstStatus2);
+				return RET_NG;
+			}
+		}
+	}
+
+	// Bs\ȃNꍇ
+	pstLinkPart = get_open_link(pstStatus2);
+	if (pstLinkPart != NULL) {
+		giSplitLinkCases++;
+		gcPruneReason = PRUNE_SPLIT_LINK;
+		DEBUG_PRINTF("\n----- split link ");
+		DEBUG_PRINT_LINK(pstLinkPart);
+		DEBUG_PRINTF(" -----\n");
+		DEBUG_PRINT_GRID(pstStatus2);
+		return RET_NG;
+	}
+
+	// V}ʂ郊N̗[̐FAV}̔̍ς
+	// ق̃V}ʂȂN͕K̃V}ʂ
+	for (iRegion = 0; iRegion < iRegionCnt; iRegion++) {
+
+		iFixed = 0;
+		iLower = 0;
+		iUpper = 0;
+		for (iPart = 0; plActiveParts[iRegion] >> iPart != 0; iPart++) {
+
+			if ((plActiveParts[iRegion] & (1ULL << iPart)) == 0) {
+				continue;
+			}
+
+			cParity = get_parity(&(pstStatus->pstLinkParts[iPart]));
+			if (pcActiveCnts[iPart] == 1) {
+				iFixed += cParity;
+			} else if (cParity < 0) {
+				iLower += cParity;
+			} else {
+				iUpper += cParity;
+			}
+		}
+
+		if (piColorDiffs[iRegion] < iFixed + iLower || piColorDiffs[iRegion] > iFixed + iUpper) {
+			giParityCases++;
+			gcPruneReason = PRUNE_PARITY;
+			DEBUG_PRINTF(
+				"\n----- parity of region %d : %d not in [%d, %d] -----\n",
+				iRegion, piColorDiffs[iRegion], iFixed + iLower, iFixed + iUpper
+			);
+			DEBUG_PRINT_GRID(pstStatus);
+			return RET_NG;
+		}
+	}
+
+	if (plGroups != NULL) {
+		*pcGroupCnt = make_groups(plActiveParts, iRegionCnt, plGroups);
+	}
+
+	return RET_OK;
+}
+
+static char make_groups(
+	unsigned long long *plActiveParts,
+	int iRegionCnt,
+	unsigned long long *plGroups
+) {
+
+	unsigned long long lParts;
+	unsigned long long lTmp;
+	int iRegion;
+	int iGroupCnt;
+	int i;
+	int j;
+
+	// Np[cʂV}܂Ƃ߂
+	iGroupCnt = 0;
+	for (iRegion = 0; iRegion < iRegionCnt; iRegion++) {
+
+		lParts = plActiveParts[iRegion];
+		for (i = 0; i < iGroupCnt; ) {
+			if ((plGroups[i] & lParts) == 0) {
+				i++;
+				continue;
+			}
+			lParts |= plGroups[i];
+			plGroups[i] = plGroups[--iGroupCnt];
+			i = 0;
+		}
+		plGroups[iGroupCnt++] = lParts;
+	}
+
+	// T̃O[vɊ܂܂̂Ap[c̏Ȃɕׂ
+	for (i = 0; i < iGroupCnt; ) {
+		if ((plGroups[i] & glFocusParts) == 0) {
+			plGroups[i] = plGroups[--iGroupCnt];
+		} else {
+			i++;
+		}
+	}
+	for (i = 1; i < iGroupCnt; i++) {
+		for (j = i; j > 0 && __builtin_popcountll(plGroups[j]) < __builtin_popcountll(plGroups[j - 1]); j--) {
+			lTmp = plGroups[j];
+			plGroups[j] = plGroups[j - 1];
+			plGroups[j - 1] = lTmp;
+		}
+	}
+
+	return iGroupCnt;
+}
+
+static char get_parity(
+	pLINK_PART pstLinkPart
+) {
+
+	char cStartColor;
+	char cEndColor;
+
+	cStartColor = (pstLinkPart->stStart.cRow + pstLinkPart->stStart.cCol) & 1;
+	cEndColor = (pstLinkPart->stEnd.cRow + pstLinkPart->stEnd.cCol) & 1;
+
+	// [ႤFȂԂ̃}X͔
+	if (cStartColor != cEndColor) {
+		return 0;
+	}
+
+	// FȂԂ̃}X͊ŁA΂̐F1
+	if (cStartColor == 0) {
+		return -1;
+	} else {
+		return 1;
+	}
+}
+
+static char fill_partition(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	char ppcExitPoints[MAX_SIZE][MAX_SIZE],
+	int *piColorCnts
+) {
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	char cFreeCnt;
+	char *pcStat;
+
+	cFreeCnt = 0;
+	get_neighbors(pstPoint, pstNeighbors);
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+
+		if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
+			continue;
+		}
+
+		cFreeCnt++;
+
+		if (atoi(pcStat) > 0) {
+			ppcExitPoints[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] = FLG_ON;
+		}
+	}
+
+	//܏HɂȂĂ
+	if (cFreeCnt <= 1) {
+		giDeadEndCases++;
+		gcPruneReason = PRUNE_DEAD_END;
+		DEBUG_PRINTF("\n----- dead end at [%d, %d] -----\n",  pstPoint->cRow, pstPoint->cCol);
+		DEBUG_PRINT_GRID(pstStatus);
+		return RET_NG;
+	}
+
+	fill_stat(pstStatus, pstPoint);
+	piColorCnts[(pstPoint->cRow + pstPoint->cCol) & 1]++;
+
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+		if (has_stat(pstStatus, &(pstNeighbor->stPoint)) == RET_OK) {
+			continue;
+		}
+
+		if (fill_partition(pstStatus, &(pstNeighbor->stPoint), ppcExitPoints, piColorCnts) != RET_OK) {
+			return RET_NG;
+		}
+	}
+
+	return RET_OK;
+}
+
+static char check_reachable(
+	pSTATUS pstStatus
+) {
+
+	char ppcFrees[MAX_SIZE][MAX_SIZE];
+	char ppcLinks[MAX_SIZE][MAX_SIZE];
+	char ppcNeeds[MAX_SIZE][MAX_SIZE];
+	short ppsRegions[MAX_SIZE][MAX_SIZE];
+	short ppsDists[MAX_SIZE][MAX_SIZE];
+	short psRegionCells[MAX_SIZE * MAX_SIZE + 1];
+	short psRegionLens[MAX_SIZE * MAX_SIZE + 1];
+	char pcFocusRegions[MAX_SIZE * MAX_SIZE + 1];
+	char pcPartLinks[MAX_PARTS + 1];
+	POINT pstQueue[MAX_SIZE * MAX_SIZE];
+	POINT pstEnds[2];
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	pLINK_PART pstLinkPart;
+	POINT stPoint;
+	pPOINT pstPoint;
+	pPOINT pstTail;
+	char *pcStat;
+	char cLinkNo;
+	char cLink;
+	char cForcedCnt;
+	char cEnd;
+	short sRegion;
+	short sRegionCnt;
+	short sDist;
+	short sMinDist;
+	short sMinRegion;
+	int iEmptyCnt;
+	int iTotalLen;
+
+	// p[c̑郊N̔ԍ (1)
+	cLinkNo = 0;
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		if (pstLinkPart->cPrev < 0) {
+			cLinkNo++;
+		}
+		pcPartLinks[pstLinkPart - pstStatus->pstLinkParts] = cLinkNo;
+	}
+
+	// [_ƂɁAƉ{Ȃ邩
+	memset(ppcLinks, '\0', sizeof(ppcLinks));
+	memset(ppcNeeds, '\0', sizeof(ppcNeeds));
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		if (pstLinkPart->cClose == FLG_ON) {
+			continue;
+		}
+		cLinkNo = pcPartLinks[pstLinkPart - pstStatus->pstLinkParts];
+		ppcLinks[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] = cLinkNo;
+		ppcLinks[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] = cLinkNo;
+		ppcNeeds[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol]++;
+		ppcNeeds[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol]++;
+	}
+
+	// 󂫃}X̒ʂׂ̐ (2Ȃʂ蓹܂Ă)
+	iEmptyCnt = 0;
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			ppcFrees[(int) stPoint.cRow][(int) stPoint.cCol] = -1;
+			if (has_stat(pstStatus, &stPoint) == RET_OK) {
+				continue;
+			}
+
+			iEmptyCnt++;
+			ppcFrees[(int) stPoint.cRow][(int) stPoint.cCol] = 0;
+			get_neighbors(&stPoint, pstNeighbors);
+			for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+				pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+				if (strcmp(pcStat + 2, CLOSE_MARK) != 0) {
+					ppcFrees[(int) stPoint.cRow][(int) stPoint.cCol]++;
+				}
+			}
+		}
+	}
+
+	// ʂ蓹܂}XAȂ悪󂯓鐔𒴂
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			pcStat = get_stat(pstStatus, &stPoint);
+			if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
+				continue;
+			}
+
+			cForcedCnt = 0;
+			get_neighbors(&stPoint, pstNeighbors);
+			for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+				if (ppcFrees[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] == 2) {
+					cForcedCnt++;
+				}
+			}
+
+			if (cForcedCnt > ((*pcStat == '\0') ? 2 : ppcNeeds[(int) stPoint.cRow][(int) stPoint.cCol])) {
+				giCorridorCases++;
+				gcPruneReason = PRUNE_CORRIDOR;
+				DEBUG_PRINTF("\n----- crowded corridors at [%d, %d] -----\n", stPoint.cRow, stPoint.cCol);
+				DEBUG_PRINT_GRID(pstStatus);
+				return RET_NG;
+			}
+		}
+	}
+
+	// ʂ蓹łȂ}X͓NɂȂ
+	memset(ppsRegions, '\0', sizeof(ppsRegions));
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			if (ppcFrees[(int) stPoint.cRow][(int) stPoint.cCol] != 2 || ppsRegions[(int) stPoint.cRow][(int) stPoint.cCol] != 0) {
+				continue;
+			}
+
+			cLink = 0;
+			pstTail = pstQueue;
+			*(pstTail++) = stPoint;
+			ppsRegions[(int) stPoint.cRow][(int) stPoint.cCol] = 1;
+
+			for (pstPoint = pstQueue; pstPoint < pstTail; pstPoint++) {
+
+				cLinkNo = ppcLinks[(int) pstPoint->cRow][(int) pstPoint->cCol];
+				if (cLinkNo != 0 && cLink != 0 && cLinkNo != cLink) {
+					giCorridorCases++;
+					gcPruneReason = PRUNE_CORRIDOR;
+					DEBUG_PRINTF("\n----- corridor of two links at [%d, %d] -----\n", stPoint.cRow, stPoint.cCol);
+					DEBUG_PRINT_GRID(pstStatus);
+					return RET_NG;
+				}
+				if (cLinkNo != 0) {
+					cLink = cLinkNo;
+				}
+
+				// [_Ŏ~߁A܂}X炾֐i
+				get_neighbors(pstPoint, pstNeighbors);
+				for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+					if (ppsRegions[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != 0) {
+						continue;
+					}
+					if (
+						ppcFrees[(int) pstPoint->cRow][(int) pstPoint->cCol] != 2
+						&& ppcFrees[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != 2
+					) {
+						continue;
+					}
+					pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+					if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
+						continue;
+					}
+
+					ppsRegions[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] = 1;
+					*(pstTail++) = pstNeighbor->stPoint;
+				}
+			}
+
+			for (pstPoint = pstQueue; pstPoint < pstTail; pstPoint++) {
+				ppcLinks[(int) pstPoint->cRow][(int) pstPoint->cCol] = cLink;
+			}
+		}
+	}
+
+	// 󂫃}X̃V}
+	memset(ppsRegions, '\0', sizeof(ppsRegions));
+	sRegionCnt = 0;
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			if (ppcFrees[(int) stPoint.cRow][(int) stPoint.cCol] < 0 || ppsRegions[(int) stPoint.cRow][(int) stPoint.cCol] != 0) {
+				continue;
+			}
+
+			sRegionCnt++;
+			pstTail = pstQueue;
+			*(pstTail++) = stPoint;
+			ppsRegions[(int) stPoint.cRow][(int) stPoint.cCol] = sRegionCnt;
+
+			for (pstPoint = pstQueue; pstPoint < pstTail; pstPoint++) {
+				get_neighbors(pstPoint, pstNeighbors);
+				for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+					if (
+						ppcFrees[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] < 0
+						|| ppsRegions[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != 0
+					) {
+						continue;
+					}
+					ppsRegions[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] = sRegionCnt;
+					*(pstTail++) = pstNeighbor->stPoint;
+				}
+			}
+
+			psRegionCells[sRegionCnt] = pstTail - pstQueue;
+			psRegionLens[sRegionCnt] = 0;
+			pcFocusRegions[sRegionCnt] = FLG_OFF;
+		}
+	}
+
+	// ̒[_܂ł̋ANɍŒKvȃ}Xςݏグ
+	iTotalLen = 0;
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+
+		if (pstLinkPart->cClose == FLG_ON) {
+			continue;
+		}
+
+		cLinkNo = pcPartLinks[pstLinkPart - pstStatus->pstLinkParts];
+		fill_distance(pstStatus, pstLinkPart, ppcLinks, cLinkNo, ppsDists);
+
+		sMinDist = -1;
+		sMinRegion = 0;
+		get_neighbors(&(pstLinkPart->stStart), pstNeighbors);
+		for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+			stPoint = pstNeighbor->stPoint;
+			if (stPoint.cRow == pstLinkPart->stEnd.cRow && stPoint.cCol == pstLinkPart->stEnd.cCol) {
+				sDist = 0;
+				sRegion = -1;
+			} else if (ppsDists[(int) stPoint.cRow][(int) stPoint.cCol] > 0) {
+				sDist = ppsDists[(int) stPoint.cRow][(int) stPoint.cCol];
+				sRegion = ppsRegions[(int) stPoint.cRow][(int) stPoint.cCol];
+			} else {
+				continue;
+			}
+
+			if (sMinDist < 0 || sDist < sMinDist) {
+				sMinDist = sDist;
+			}
+			// ʂV}1Ɍ܂ƂÃV}ɐς
+			if (sMinRegion == 0) {
+				sMinRegion = sRegion;
+			} else if (sMinRegion != sRegion) {
+				sMinRegion = -1;
+			}
+		}
+
+		if (sMinDist < 0) {
+			giUnreachableCases++;
+			gcPruneReason = PRUNE_UNREACHABLE;
+			DEBUG_PRINTF("\n----- unreachable link ");
+			DEBUG_PRINT_LINK(pstLinkPart);
+			DEBUG_PRINTF(" -----\n");
+			DEBUG_PRINT_GRID(pstStatus);
+			return RET_NG;
+		}
+
+		// O[vƂɉĂԂ́ÃO[ṽNƁA̒[_ɐڂV}̃}XŔׂ
+		// (Ȃ̓O[v̌`ŊôŁAق̃O[v̕Ȃ)
+		if (giActiveFrame >= 0) {
+			if ((glFocusParts & (1ULL << (pstLinkPart - pstStatus->pstLinkParts))) != 0) {
+				iTotalLen += sMinDist;
+				pstEnds[0] = pstLinkPart->stStart;
+				pstEnds[1] = pstLinkPart->stEnd;
+				for (cEnd = 0; cEnd < 2; cEnd++) {
+					get_neighbors(&pstEnds[(int) cEnd], pstNeighbors);
+					for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+						pcFocusRegions[ppsRegions[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol]] = FLG_ON;
+					}
+				}
+			}
+		} else {
+			iTotalLen += sMinDist;
+		}
+
+		if (sMinRegion > 0) {
+			psRegionLens[sMinRegion] += sMinDist;
+			if (psRegionLens[sMinRegion] > psRegionCells[sMinRegion]) {
+				giShortLengthCases++;
+				gcPruneReason = PRUNE_SHORT_LENGTH;
+				DEBUG_PRINTF("\n----- region %d too small for links -----\n", sMinRegion);
+				DEBUG_PRINT_GRID(pstStatus);
+				return RET_NG;
+			}
+		}
+	}
+
+	if (giActiveFrame >= 0) {
+		iEmptyCnt = 0;
+		for (sRegion = 1; sRegion <= sRegionCnt; sRegion++) {
+			if (pcFocusRegions[sRegion] == FLG_ON) {
+				iEmptyCnt += psRegionCells[sRegion];
+			}
+		}
+	}
+
+	if (iTotalLen > iEmptyCnt) {
+		giShortLengthCases++;
+		gcPruneReason = PRUNE_SHORT_LENGTH;
+		DEBUG_PRINTF("\n----- %d cells too small for links -----\n", iEmptyCnt);
+		DEBUG_PRINT_GRID(pstStatus);
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static void fill_distance(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart,
+	char ppcLinks[MAX_SIZE][MAX_SIZE],
+	char cLinkNo,
+	short ppsDists[MAX_SIZE][MAX_SIZE]
+) {
+
+	POINT pstQueue[MAX_SIZE * MAX_SIZE];
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	pPOINT pstPoint;
+	pPOINT pstTail;
+	short sDist;
+
+	// I_̋ (0͖B)B̃NɌ܂}X͒ʂȂ
+	memset(ppsDists, '\0', sizeof(short) * MAX_SIZE * MAX_SIZE);
+
+	pstTail = pstQueue;
+	*(pstTail++) = pstLinkPart->stEnd;
+
+	for (pstPoint = pstQueue; pstPoint < pstTail; pstPoint++) {
+
+		sDist = ppsDists[(int) pstPoint->cRow][(int) pstPoint->cCol] + 1;
+
+		get_neighbors(pstPoint, pstNeighbors);
+		for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+			if (ppsDists[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != 0) {
+				continue;
+			}
+			if (has_stat(pstStatus, &(pstNeighbor->stPoint)) == RET_OK) {
+				continue;
+			}
+			if (
+				ppcLinks[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != 0
+				&& ppcLinks[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] != cLinkNo
+			) {
+				continue;
+			}
+
+			ppsDists[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] = sDist;
+			*(pstTail++) = pstNeighbor->stPoint;
+		}
+	}
+}
+
+static char check_forward1(
+	pSTATUS pstStatus
+) {
+	POINT stPoint;
+
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+			if (is_fd1_point(pstStatus, &stPoint) != RET_OK) {
+				continue;
+			}
+			if (check_forward1_at(pstStatus, &stPoint) != RET_OK) {
+				return RET_NG;
+			}
+		}
+	}
+
+	return RET_OK;
+}
+
+static char check_forward1_at(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+
+	pSTATUS pstStatus2;
+	POINT stPoint;
+	char (*ppcExitPoints)[MAX_SIZE];
+	pLINK_PART pstLinkPart;
+	char cActiveCnt;
+
+	pstStatus2 = &(gpstProbe->stStatus);
+	ppcExitPoints = gpstProbe->ppcExitPoints;
+
+	memcpy(pstStatus2, pstStatus, sizeof(STATUS));
+	set_stat(pstStatus2, pstPoint, "0", CLOSE_MARK);
+
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+
+			if (has_stat(pstStatus2, &stPoint) == RET_OK) {
+				continue;
+			}
+
+			memset(ppcExitPoints, '\0', sizeof(gpstProbe->ppcExitPoints));
+			fill_partition_forward1(pstStatus2, &stPoint, ppcExitPoints);
+
+//			DEBUG_PRINTF("  forward : [%d, %d], exit : ", stPoint.cRow, stPoint.cCol);
+//			DEBUG_PRINT_EXIT(ppcExitPoints);
+//			DEBUG_PRINTF("\n");
+
+			if (memcmp(ppcExitPoints, gppcZeroExitPoints, sizeof(gpstProbe->ppcExitPoints)) == 0) {
+				giFd1DeadPartitionCases++;
+				gcPruneReason = PRUNE_FD1_DEAD_PARTITION;
+				DEBUG_PRINTF(
+					"\n----- dead partition by [%d, %d] at [%d, %d] -----\n",
+					pstPoint->cRow, pstPoint->cCol, stPoint.cRow, stPoint.cCol
+				);
+				DEBUG_PRINT_GRID(pstStatus2);
+				return RET_NG;
+			}
+
+			for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+				if (pstLinkPart->cClose == FLG_ON) {
+					continue;
+				}
+				if (ppcExitPoints[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] != FLG_ON) {
+					continue;
+				}
+				if (ppcExitPoints[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] != FLG_ON) {
+					continue;
+				}
+				pstStatus2->pstLinkParts[pstLinkPart - pstStatus->pstLinkParts].cClose = FLG_ON;
+			}
+		}
+	}
+
+	cActiveCnt = 0;
+	for (pstLinkPart = pstStatus2->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		if (pstLinkPart->cClose == FLG_ON) {
+			continue;
+		}
+		cActiveCnt++;
+		if (cActiveCnt > 1) {
+			giMultiSplitCases++;
+			gcPruneReason = PRUNE_MULTI_SPLIT;
+			DEBUG_PRINTF("\n----- multiple split at [%d, %d] for ", pstPoint->cRow, pstPoint->cCol);
+			DEBUG_PRINT_LINKS(pstStatus2->pstLinkParts);
+			DEBUG_PRINTF(" -----\n");
+			DEBUG_PRINT_GRID(pstStatus2);
+			return RET_NG;
+		}
+	}
+
+	return RET_OK;
+}
+
+static void fill_partition_forward1(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	char ppcExitPoints[MAX_SIZE][MAX_SIZE]
+) {
+
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	char *pcStat;
+
+	fill_stat(pstStatus, pstPoint);
+
+	get_neighbors(pstPoint, pstNeighbors);
+	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+
+		if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
+			continue;
+		}
+
+		if (atoi(pcStat) > 0) {
+			ppcExitPoints[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] = FLG_ON;
+		}
+
+		if (has_stat(pstStatus, &(pstNeighbor->stPoint)) == RET_OK) {
+			continue;
+		}
+
+		fill_partition_forward1(pstStatus, &(pstNeighbor->stPoint), ppcExitPoints);
+	}
+}
+
+static void open_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	const char *pcLinkName,
+	const char *pcMark
+) {
+
+	set_stat(pstStatus, pstPoint, pcLinkName, pcMark);
+	update_fd1_point(pstStatus, pstPoint);
+
+}
+
+static void set_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	const char *pcLinkName,
+	const char *pcMark
+) {
+
+	char *pcDest = pstStatus->pppcStats[(int) pstPoint->cRow][(int) pstPoint->cCol];
+	make_stat(pcDest, pcLinkName, pcMark);
+}
+
+static void make_stat(
+	char *pcStat,
+	const char *pcLinkName,
+	const char *pcMark
+) {
+
+	char cHigh;
+	char cLow;
+
+	// "%2s%1s" Ɠ` (N 2 ܂ŁAE)
+	// N͓Ֆʂ pstLinkParts n̂ŁAǂł珑
+	if (pcLinkName[1] == '\0') {
+		cHigh = ' ';
+		cLow = pcLinkName[0];
+	} else {
+		cHigh = pcLinkName[0];
+		cLow = pcLinkName[1];
+	}
+
+	pcStat[0] = cHigh;
+	pcStat[1] = cLow;
+	if (pcMark == NULL) {
+		pcStat[2] = '\0';
+	} else {
+		pcStat[2] = pcMark[0];
+		pcStat[3] = '\0';
+	}
+}
+
+static void close_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	char *pcDest = pstStatus->pppcStats[(int) pstPoint->cRow][(int) pstPoint->cCol];
+	strcpy(pcDest + 2, CLOSE_MARK);
+}
+
+static void fill_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	char *pcDest = pstStatus->pppcStats[(int) pstPoint->cRow][(int) pstPoint->cCol];
+	strcpy(pcDest, FILLER);
+}
+
+static char* get_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	return pstStatus->pppcStats[(int) pstPoint->cRow][(int) pstPoint->cCol];
+}
+
+static char has_stat(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+
+	if (*get_stat(pstStatus, pstPoint) == '\0') {
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static void set_direction(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	pDIRECTION pstDir
+) {
+
+	// ͕`ƂɑgݗĂ̂ŁAł͐iތc
+	pstStatus->ppcDirs[(int) pstPoint->cRow][(int) pstPoint->cCol] = pstDir - gpstDirections;
+}
+
+static char get_line_dir(
+	pSTATUS pstStatus,
+	pPOINT pstPoint,
+	pNEIGHBOR pstNeighbor
+) {
+
+	char cDir = pstNeighbor->pstDir - gpstDirections;
+
+	// ڂźAǂ炩̃}XoĂ
+	if (pstStatus->ppcDirs[(int) pstPoint->cRow][(int) pstPoint->cCol] == cDir) {
+		return cDir;
+	}
+
+	cDir = (cDir + 2) % NEIGHBOR_CNT;
+	if (pstStatus->ppcDirs[(int) pstNeighbor->stPoint.cRow][(int) pstNeighbor->stPoint.cCol] == cDir) {
+		return cDir;
+	}
+
+	return DIR_NONE;
+}
+
+static void get_neighbors(
+	pPOINT pstPoint,
+	pNEIGHBOR pstNeighbors
+) {
+
+	pDIRECTION pstDirection;
+	char c;
+	char cRow;
+	char cCol;
+
+	memset(pstNeighbors, '\0', sizeof(NEIGHBOR) * (NEIGHBOR_CNT + 1));
+
+	for (pstDirection = gpstDirections, c = 0; c < NEIGHBOR_CNT; pstDirection++, c++) {
+
+		cRow= pstPoint->cRow + pstDirection->cRowDelta;
+		if (cRow < 0 || cRow >= gcSize) {
+			continue;
+		}
+
+		cCol = pstPoint->cCol + pstDirection->cColDelta;
+		if (cCol < 0 || cCol >= gcSize) {
+			continue;
+		}
+
+		pstNeighbors->pstDir = pstDirection;
+		pstNeighbors->stPoint.cRow = cRow;
+		pstNeighbors->stPoint.cCol = cCol;
+		pstNeighbors++;
+	}
+
+}
+
+static void close_connected_link(
+	pSTATUS pstStatus,
+	pLINK_PART pstLinkPart
+) {
+
+	POINT stFrom = pstLinkPart->stStart;
+	POINT stTo = pstLinkPart->stEnd;
+	pDIRECTION pstDirection;
+	char c;
+	char cPrev;
+	char cNext;
+
+	for (pstDirection = gpstDirections, c = 0; c < NEIGHBOR_CNT; pstDirection++, c++) {
+		if (
+			(stTo.cRow - stFrom.cRow == pstDirection->cRowDelta)
+			&& (stTo.cCol - stFrom.cCol == pstDirection->cColDelta)
+		) {
+			break;
+		}
+	}
+
+	if (c >= NEIGHBOR_CNT) {
+		return;
+	}
+
+	cPrev = pstLinkPart->cPrev;
+	if (cPrev < 0) {
+		close_stat(pstStatus, &stFrom);
+	} else if (pstStatus->pstLinkParts[(int) cPrev].cClose == FLG_ON) {
+		close_stat(pstStatus, &stFrom);
+	}
+	set_direction(pstStatus, &stFrom, pstDirection);
+	cNext = pstLinkPart->cNext;
+	if (cNext < 0) {
+		close_stat(pstStatus, &stTo);
+	} else if (pstStatus->pstLinkParts[(int) cNext].cClose == FLG_ON) {
+		close_stat(pstStatus, &stTo);
+	}
+	pstLinkPart->cClose = FLG_ON;
+
+	DEBUG_PRINTF("\n ----- link ");
+	DEBUG_PRINT_LINK(pstLinkPart);
+	DEBUG_PRINTF(" closed. -----\n");
+	DEBUG_PRINT_GRID(pstStatus);
+
+}
+
+static pLINK_PART get_focus_link(
+	pSTATUS pstStatus
+) {
+
+	pLINK_PART pstLinkPart;
+	char c;
+
+	for (c = 0; c < gcPartCnt; c++) {
+		pstLinkPart = pstStatus->pstLinkParts + gpcPartOrder[(int) c];
+		if (pstLinkPart->cClose == FLG_OFF && (glFocusParts & (1ULL << gpcPartOrder[(int) c])) != 0) {
+			return pstLinkPart;
+		}
+	}
+
+	return NULL;
+}
+
+static void get_nogood_key(
+	pSTATUS pstStatus,
+	pNOGOOD pstKey
+) {
+
+	POINT pstQueue[MAX_SIZE * MAX_SIZE];
+	char ppcSeen[MAX_SIZE][MAX_SIZE];
+	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
+	pNEIGHBOR pstNeighbor;
+	pLINK_PART pstLinkPart;
+	POINT stPoint;
+	unsigned long long lKey;
+	unsigned long long lCheck;
+	unsigned long long lPart;
+	unsigned long long lStat;
+	char *pcStat;
+	int iHead;
+	int iTail;
+	int i;
+
+	memset(ppcSeen, '\0', sizeof(ppcSeen));
+	lKey = 0;
+	lCheck = 0;
+	iTail = 0;
+
+	// ڂĂ郊N̒[_ƁA̒[_͂󂫃}Xŕ肪܂
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+
+		i = pstLinkPart - pstStatus->pstLinkParts;
+		if (pstLinkPart->cClose == FLG_ON || (glFocusParts & (1ULL << i)) == 0) {
+			continue;
+		}
+
+		lPart = gpplCellKeys[(int) pstLinkPart->stStart.cRow][(int) pstLinkPart->stStart.cCol] * 3
+			+ gpplCellKeys[(int) pstLinkPart->stEnd.cRow][(int) pstLinkPart->stEnd.cCol] * 5
+			+ ((unsigned long long) *get_stat(pstStatus, &(pstLinkPart->stEnd)) << 8)
+			+ i;
+		lKey ^= mix_key(lPart);
+		lCheck += mix_key(lPart ^ NOGOOD_CHECK_SALT);
+
+		pstQueue[iTail++] = pstLinkPart->stStart;
+		pstQueue[iTail++] = pstLinkPart->stEnd;
+	}
+
+	for (iHead = 0; iHead < iTail; iHead++) {
+
+		stPoint = pstQueue[iHead];
+		get_neighbors(&stPoint, pstNeighbors);
+
+		for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+
+			stPoint = pstNeighbor->stPoint;
+			if (ppcSeen[(int) stPoint.cRow][(int) stPoint.cCol] == FLG_ON) {
+				continue;
+			}
+			ppcSeen[(int) stPoint.cRow][(int) stPoint.cCol] = FLG_ON;
+
+			if (has_stat(pstStatus, &stPoint) != RET_OK) {
+				lPart = gpplCellKeys[(int) stPoint.cRow][(int) stPoint.cCol];
+				lKey += lPart;
+				lCheck ^= mix_key(lPart ^ NOGOOD_CHECK_SALT);
+				pstQueue[iTail++] = stPoint;
+				continue;
+			}
+
+			// ̃}Xǂ̃N̂̂ (̐ɐG͎}Ƃė)
+			lStat = 0;
+			for (pcStat = get_stat(pstStatus, &stPoint); *pcStat != '\0'; pcStat++) {
+				lStat = (lStat << 8) | (unsigned char) *pcStat;
+			}
+			lPart = mix_key(gpplCellKeys[(int) stPoint.cRow][(int) stPoint.cCol] + lStat);
+			lKey += lPart;
+			lCheck ^= mix_key(lPart ^ NOGOOD_CHECK_SALT);
+		}
+	}
+
+	pstKey->lKey = mix_key(lKey);
+	if (pstKey->lKey == 0) {
+		pstKey->lKey = 1;
+	}
+	pstKey->lCheck = mix_key(lCheck);
+}
+
+static unsigned long long mix_key(
+	unsigned long long lKey
+) {
+
+	lKey += 0x9e3779b97f4a7c15ULL;
+	lKey = (lKey ^ (lKey >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	lKey = (lKey ^ (lKey >> 27)) * 0x94d049bb133111ebULL;
+
+	return lKey ^ (lKey >> 31);
+}
+
+static char has_nogood_group(
+	pSTATUS pstStatus,
+	unsigned long long *plGroups,
+	char cGroupCnt,
+	pNOGOOD pstFirstKey
+) {
+
+	unsigned long long lSavedFocus;
+	NOGOOD stKey;
+	char cRet;
+	char c;
+
+	lSavedFocus = glFocusParts;
+	cRet = RET_NG;
+
+	for (c = 0; c < cGroupCnt; c++) {
+		glFocusParts = plGroups[(int) c];
+		get_nogood_key(pstStatus, &stKey);
+		if (c == 0) {
+			*pstFirstKey = stKey;
+		}
+		if (has_nogood(&stKey) == RET_OK) {
+			cRet = RET_OK;
+			break;
+		}
+	}
+
+	glFocusParts = lSavedFocus;
+
+	return cRet;
+}
+
+static char has_nogood(
+	pNOGOOD pstKey
+) {
+
+	int iSlot;
+
+	if (gcNogood == FLG_OFF) {
+		return RET_NG;
+	}
+
+	// Ԃ̕ʂ̕Ŏ}𗎂ƂȂ悤A 1 ̌łm߂
+	iSlot = (int) (pstKey->lKey & NOGOOD_MASK);
+	if (
+		(gpstNogoods[iSlot].lKey == pstKey->lKey && gpstNogoods[iSlot].lCheck == pstKey->lCheck)
+		|| (gpstNogoods[iSlot ^ 1].lKey == pstKey->lKey && gpstNogoods[iSlot ^ 1].lCheck == pstKey->lCheck)
+	) {
+		return RET_OK;
+	}
+
+	return RET_NG;
+}
+
+static void add_nogood(
+	pNOGOOD pstKey
+) {
+
+	int iSlot;
+
+	if (gcNogood == FLG_OFF) {
+		return;
+	}
+
+	// 2 ̘ĝÂقo
+	iSlot = (int) (pstKey->lKey & NOGOOD_MASK);
+	if (gpstNogoods[iSlot].lKey != pstKey->lKey || gpstNogoods[iSlot].lCheck != pstKey->lCheck) {
+		gpstNogoods[iSlot ^ 1] = gpstNogoods[iSlot];
+		gpstNogoods[iSlot] = *pstKey;
+	}
+}
+
+static pLINK_PART get_open_link(
+	pSTATUS pstStatus
+) {
+	pLINK_PART pstLinkPart;
+
+	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
+		if (pstLinkPart->cClose == FLG_OFF) {
+			return pstLinkPart;
+		}
+	}
+
+	return NULL;
+}
+
+static void set_fd1_point(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	pstStatus->ppcFd1Flags[(int) pstPoint->cRow][(int) pstPoint->cCol] = FLG_ON;
+}
+
+static void delete_fd1_point(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	pstStatus->ppcFd1Flags[(int) pstPoint->cRow][(int) pstPoint->cCol] = FLG_OFF;
+}
+
+static void update_fd1_point(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+
+	POINT stAround;
+	char cRowDelta;
+	char cColDelta;
+
+	delete_fd1_point(pstStatus, pstPoint);
+
+	//  5x5 ĝŁAe͈͂ 5x5
+	for (cRowDelta = -WINDOW_RADIUS; cRowDelta <= WINDOW_RADIUS; cRowDelta++) {
+		for (cColDelta = -WINDOW_RADIUS; cColDelta <= WINDOW_RADIUS; cColDelta++) {
+
+			stAround.cRow = pstPoint->cRow + cRowDelta;
+			stAround.cCol = pstPoint->cCol + cColDelta;
+			if (
+				stAround.cRow < 0 || stAround.cRow >= gcSize
+				|| stAround.cCol < 0 || stAround.cCol >= gcSize
+			) {
+				continue;
+			}
+
+			if (has_stat(pstStatus, &stAround) == RET_OK) {
+				continue;
+			}
+
+			if (has_split_at(pstStatus, &stAround) != RET_OK) {
+				delete_fd1_point(pstStatus, &stAround);
+				continue;
+			}
+
+			set_fd1_point(pstStatus, &stAround);
+		}
+	}
+
+}
+
+static char is_fd1_point(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+	if (pstStatus->ppcFd1Flags[(int) pstPoint->cRow][(int) pstPoint->cCol] == FLG_ON) {
+		return RET_OK;
+	} else {
+		return RET_NG;
+	}
+}
+
+static char has_split_at(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+
+	pDIRECTION pstDirection;
+	char c;
+	char cRow;
+	char cCol;
+	POINT stAround;
+	int iAroundPat;
+	int iAroundFlg;
+
+	iAroundPat = 0;
+	for (pstDirection = gpstArounds, c = 0; c < AROUND_CNT; pstDirection++, c++) {
+
+		iAroundFlg = 1 << c;
+
+		cRow = pstPoint->cRow + pstDirection->cRowDelta;
+		if (cRow < 0 || cRow >= gcSize) {
+			iAroundPat |= iAroundFlg;
+			continue;
+		}
+
+		cCol = pstPoint->cCol + pstDirection->cColDelta;
+		if (cCol < 0 || cCol >= gcSize) {
+			iAroundPat |= iAroundFlg;
+			continue;
+		}
+
+		stAround.cRow = cRow;
+		stAround.cCol = cCol;
+		if (has_stat(pstStatus, &stAround) == RET_OK) {
+			iAroundPat |= iAroundFlg;
+		}
+	}
+
+	if (gpcSplitPatternTbl[iAroundPat] != FLG_ON) {
+		return RET_NG;
+	}
+
+	return is_window_cut(get_window_pattern(pstStatus, pstPoint));
+}
+
+static int get_window_pattern(
+	pSTATUS pstStatus,
+	pPOINT pstPoint
+) {
+
+	POINT stAround;
+	char cRowDelta;
+	char cColDelta;
+	int iWindowPat;
+	int iWindowFlg;
+
+	// S24}XAՊO܂߂čǂĂ1Ƃ
+	iWindowPat = 0;
+	iWindowFlg = 1;
+	for (cRowDelta = -WINDOW_RADIUS; cRowDelta <= WINDOW_RADIUS; cRowDelta++) {
+		for (cColDelta = -WINDOW_RADIUS; cColDelta <= WINDOW_RADIUS; cColDelta++) {
+
+			if (cRowDelta == 0 && cColDelta == 0) {
+				continue;
+			}
+
+			stAround.cRow = pstPoint->cRow + cRowDelta;
+			stAround.cCol = pstPoint->cCol + cColDelta;
+			if (
+				stAround.cRow < 0 || stAround.cRow >= gcSize
+				|| stAround.cCol < 0 || stAround.cCol >= gcSize
+				|| has_stat(pstStatus, &stAround) == RET_OK
+			) {
+				iWindowPat |= iWindowFlg;
+			}
+			iWindowFlg <<= 1;
+		}
+	}
+
+	return iWindowPat;
+}
+
+static char is_window_cut(
+	int iWindowPat
+) {
+
+	int iIndex;
+	unsigned char cBit;
+	int iLow;
+	int iEmpty;
+	int iNeighbors;
+	int iReached;
+	int iPrev;
+
+	iIndex = iWindowPat >> 3;
+	cBit = 1 << (iWindowPat & 0x07);
+
+	if ((gpcWindowKnown[iIndex] & cBit) == 0) {
+
+		// S̈ʒuɍǂ}Xݍ 5x5 ̕тɖ߂
+		iLow = iWindowPat & ((1 << WINDOW_CENTER) - 1);
+		iEmpty = ~(iLow | (1 << WINDOW_CENTER) | ((iWindowPat ^ iLow) << 1)) & WINDOW_ALL;
+
+		iNeighbors = iEmpty & (
+			(1 << (WINDOW_CENTER - WINDOW_WIDTH)) | (1 << (WINDOW_CENTER - 1))
+			| (1 << (WINDOW_CENTER + 1)) | (1 << (WINDOW_CENTER + WINDOW_WIDTH))
+		);
+
+		// ׂ̋󂫃}X1璆Sʂ炸ɍL
+		iReached = iNeighbors & -iNeighbors;
+		do {
+			iPrev = iReached;
+			iReached |= (
+				(iReached << WINDOW_WIDTH) | (iReached >> WINDOW_WIDTH)
+				| ((iReached << 1) & ~WINDOW_COL0)
+				| ((iReached >> 1) & ~(WINDOW_COL0 << (WINDOW_WIDTH - 1)))
+			) & iEmpty;
+		} while (iReached != iPrev);
+
+		if ((iNeighbors & ~iReached) != 0) {
+			gpcWindowCut[iIndex] |= cBit;
+		}
+		gpcWindowKnown[iIndex] |= cBit;
+	}
+
+	if ((gpcWindowCut[iIndex] & cBit) != 0) {
+		return RET_OK;
+	} else {
+		return RET_NG;
+	}
+}
+
+static double get_clock(void) {
+
+	struct timespec stTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &stTime);
+	return stTime.tv_sec + stTime.tv_nsec / 1e9;
+}
+
+static void set_signal(
+	int iSignal,
+	void (*pfHandler)(int)
+) {
+
+	struct sigaction stAction;
+
+	// ҂킹̃VXeR[f
+	memset(&stAction, '\0', sizeof(stAction));
+	stAction.sa_handler = pfHandler;
+	sigemptyset(&stAction.sa_mask);
+	stAction.sa_flags = 0;
+	sigaction(iSignal, &stAction, NULL);
+}
+
+static void on_signal(
+	int iSignal
+) {
+	gcCancel = FLG_ON;
+}
+
+static void check_limits(void) {
+
+	struct rusage stUsage;
+
+	giNextCheck = giNodeCases + CHECK_INTERVAL;
+
+	if (giMaxNodes > 0) {
+		if (giNodeCases >= giMaxNodes) {
+			gcStopReason = STOP_NODES;
+		} else if (giNextCheck > giMaxNodes) {
+			giNextCheck = giMaxNodes;
+		}
+	}
+
+	if (giRestartLimit > 0) {
+		if (giNodeCases >= giRestartLimit) {
+			gcStopReason = STOP_RESTART;
+		} else if (giNextCheck > giRestartLimit) {
+			giNextCheck = giRestartLimit;
+		}
+	}
+
+	if (gcCancel == FLG_ON) {
+		gcStopReason = STOP_CANCEL;
+	}
+
+	if (gcStopReason == STOP_NONE && gpstClient != NULL && check_client(gpstClient) != RET_OK) {
+		gcStopReason = STOP_CANCEL;
+	}
+
+	if (gdTimeLimit > 0 && get_clock() >= gdDeadline) {
+		gcStopReason = STOP_TIME;
+	}
+
+	if (giMaxMemory > 0) {
+		getrusage(RUSAGE_SELF, &stUsage);
+		if (stUsage.ru_maxrss >= giMaxMemory * 1024) {
+			gcStopReason = STOP_MEMORY;
+		}
+	}
+
+	if (gcStopReason == STOP_NONE) {
+		check_checkpoint();
+	} else if (gpcCheckpointFile != NULL && gcStopReason != STOP_RESTART) {
+		// fʒuĊJł悤ɂĂ
+		save_checkpoint(gpcCheckpointFile);
+	}
+}
+
+static void print_result(void) {
+
+	static const char *ppcResults[] = {
+		"unsat",
+		"solved",
+		"budget exhausted (nodes)",
+		"budget exhausted (time)",
+		"budget exhausted (memory)",
+		"canceled"
+	};
+
+	time_t tNowTime;
+	struct rusage stUsage;
+	int iOffCnt;
+	int i;
+
+	time(&tNowTime);
+	getrusage(RUSAGE_SELF, &stUsage);
+
+	printf(
+		"\nresult:%s, nodes:%ld, elapsed:%d, maxrss:%ldKB, arena:%ldKB, order:%s",
+		ppcResults[(int) gcStopReason],
+		giNodeCases,
+		(int) difftime(tNowTime, gtStartTime),
+		stUsage.ru_maxrss,
+		(gstArena.iPeak + 1023) / 1024,
+		gppcOrderNames[(int) gcOrder]
+	);
+	if (gcCount == FLG_ON) {
+		printf(", solutions:%ld", giSolutionCases);
+	}
+	if (gcAutoTune == FLG_ON) {
+		iOffCnt = 0;
+		for (i = 0; i <= MAX_DEPTH; i++) {
+			if (gpcFd1Off[i] == FLG_ON) {
+				iOffCnt++;
+			}
+		}
+		printf(", fd1 off:%d", iOffCnt);
+	}
+	if (gcSchedule == FLG_ON) {
+		printf(
+			", skipped pt:%ld, fd1:%ld",
+			gplSchedSkips[SCHED_PARTITION],
+			gplSchedSkips[SCHED_FORWARD1]
+		);
+	}
+	printf("\n");
+}
+
+static unsigned long get_def_hash(void) {
+
+	unsigned char *pbByte;
+	unsigned long lHash;
+
+	// FNV-1a
+	lHash = 14695981039346656037UL;
+	lHash = (lHash ^ (unsigned char) gcSize) * 1099511628211UL;
+	// O̗LŒT̎n܂ՖʂςAוŒT؂ς
+	lHash = (lHash ^ (unsigned char) gcPresolve) * 1099511628211UL;
+	lHash = (lHash ^ (unsigned char) gcOrder) * 1099511628211UL;
+	for (pbByte = (unsigned char *) gpstLinkDefs; pbByte < (unsigned char *) (gpstLinkDefs + MAX_DEFS + 1); pbByte++) {
+		lHash = (lHash ^ *pbByte) * 1099511628211UL;
+	}
+	for (pbByte = (unsigned char *) gpstPathDefs; pbByte < (unsigned char *) (gpstPathDefs + MAX_PATHS + 1); pbByte++) {
+		lHash = (lHash ^ *pbByte) * 1099511628211UL;
+	}
+
+	return lHash;
+}
+
+static void check_checkpoint(void) {
+
+	time_t tNowTime;
+
+	if (gpcCheckpointFile == NULL) {
+		return;
+	}
+
+	time(&tNowTime);
+	if (difftime(tNowTime, gtCheckpointTime) < giCheckpointInterval) {
+		return;
+	}
+
+	save_checkpoint(gpcCheckpointFile);
+	gtCheckpointTime = tNowTime;
+}
+
+static char save_checkpoint(
+	const char *pcFileName
+) {
+
+	CHECKPOINT stCheckpoint;
+	char pcTmpName[FILENAME_MAX];
+	FILE *pstFile;
+	time_t tNowTime;
+
+	memset(&stCheckpoint, '\0', sizeof(stCheckpoint));
+	memcpy(stCheckpoint.pcMagic, CKPT_MAGIC, sizeof(stCheckpoint.pcMagic));
+	stCheckpoint.cVersion = CKPT_VERSION;
+	stCheckpoint.cSize = gcSize;
+	stCheckpoint.sDepth = giDepth;
+	stCheckpoint.lDefHash = get_def_hash();
+
+	time(&tNowTime);
+	stCheckpoint.iElapsed = (long) difftime(tNowTime, gtStartTime);
+	get_counters(&stCheckpoint);
+
+	// ̃t@CcȂ悤ꎞt@Cu
+	snprintf(pcTmpName, sizeof(pcTmpName), "%s.tmp", pcFileName);
+	pstFile = fopen(pcTmpName, "wb");
+	if (pstFile == NULL) {
+		printf("checkpoint open failed. file : %s, errno = %d\n", pcTmpName, errno);
+		return RET_NG;
+	}
+
+	if (
+		fwrite(&stCheckpoint, sizeof(stCheckpoint), 1, pstFile) != 1
+		|| fwrite(gpcMoves, sizeof(char), giDepth, pstFile) != (size_t) giDepth
+	) {
+		printf("checkpoint write failed. file : %s, errno = %d\n", pcTmpName, errno);
+		fclose(pstFile);
+		return RET_NG;
+	}
+
+	fclose(pstFile);
+
+	if (rename(pcTmpName, pcFileName) != 0) {
+		printf("checkpoint rename failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	return RET_OK;
+}
+
+static char load_checkpoint(
+	const char *pcFileName
+) {
+
+	CHECKPOINT stCheckpoint;
+	FILE *pstFile;
+
+	pstFile = fopen(pcFileName, "rb");
+	if (pstFile == NULL) {
+		printf("checkpoint open failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	if (fread(&stCheckpoint, sizeof(stCheckpoint), 1, pstFile) != 1) {
+		printf("%s : checkpoint header broken.\n", pcFileName);
+		fclose(pstFile);
+		return RET_NG;
+	}
+
+	if (
+		memcmp(stCheckpoint.pcMagic, CKPT_MAGIC, sizeof(stCheckpoint.pcMagic)) != 0
+		|| stCheckpoint.cVersion != CKPT_VERSION
+	) {
+		printf("%s : not a checkpoint file.\n", pcFileName);
+		fclose(pstFile);
+		return RET_NG;
+	}
+
+	if (stCheckpoint.cSize != gcSize || stCheckpoint.lDefHash != get_def_hash()) {
+		printf("%s : checkpoint does not match the definition.\n", pcFileName);
+		fclose(pstFile);
+		return RET_NG;
+	}
+
+	if (
+		stCheckpoint.sDepth < 0
+		|| stCheckpoint.sDepth > MAX_DEPTH
+		|| fread(gpcMoves, sizeof(char), stCheckpoint.sDepth, pstFile) != (size_t) stCheckpoint.sDepth
+	) {
+		printf("%s : checkpoint moves broken.\n", pcFileName);
+		fclose(pstFile);
+		return RET_NG;
+	}
+
+	fclose(pstFile);
+
+	giResumeDepth = stCheckpoint.sDepth;
+	gtStartTime -= stCheckpoint.iElapsed;
+	set_counters(&stCheckpoint);
+	giNextCheck = giNodeCases + CHECK_INTERVAL;
+	if (giMaxNodes > 0 && giMaxNodes < giNextCheck) {
+		giNextCheck = giMaxNodes;
+	}
+
+	return RET_OK;
+}
+
+static void get_counters(
+	pCHECKPOINT pstCheckpoint
+) {
+	pstCheckpoint->iNodeCases = giNodeCases;
+	pstCheckpoint->iOkCases = giOkCases;
+	pstCheckpoint->iBranchErrCases = giBranchErrCases;
+	pstCheckpoint->iDeadEndCases = giDeadEndCases;
+	pstCheckpoint->iDeadPartitionCases = giDeadPartitionCases;
+	pstCheckpoint->iSplitLinkCases = giSplitLinkCases;
+	pstCheckpoint->iFd1DeadPartitionCases = giFd1DeadPartitionCases;
+	pstCheckpoint->iMultiSplitCases = giMultiSplitCases;
+	pstCheckpoint->iCorridorCases = giCorridorCases;
+	pstCheckpoint->iUnreachableCases = giUnreachableCases;
+	pstCheckpoint->iShortLengthCases = giShortLengthCases;
+	pstCheckpoint->iParityCases = giParityCases;
+	pstCheckpoint->iGroupCases = giGroupCases;
+	pstCheckpoint->iGroupCutCases = giGroupCutCases;
+	pstCheckpoint->iNogoodCases = giNogoodCases;
+	pstCheckpoint->iRestartCases = giRestartCases;
+	pstCheckpoint->iSymmetryCases = giSymmetryCases;
+}
+
+static void set_counters(
+	pCHECKPOINT pstCheckpoint
+) {
+	giNodeCases = pstCheckpoint->iNodeCases;
+	giOkCases = pstCheckpoint->iOkCases;
+	giBranchErrCases = pstCheckpoint->iBranchErrCases;
+	giDeadEndCases = pstCheckpoint->iDeadEndCases;
+	giDeadPartitionCases = pstCheckpoint->iDeadPartitionCases;
+	giSplitLinkCases = pstCheckpoint->iSplitLinkCases;
+	giFd1DeadPartitionCases = pstCheckpoint->iFd1DeadPartitionCases;
+	giMultiSplitCases = pstCheckpoint->iMultiSplitCases;
+	giCorridorCases = pstCheckpoint->iCorridorCases;
+	giUnreachableCases = pstCheckpoint->iUnreachableCases;
+	giShortLengthCases = pstCheckpoint->iShortLengthCases;
+	giParityCases = pstCheckpoint->iParityCases;
+	giGroupCases = pstCheckpoint->iGroupCases;
+	giGroupCutCases = pstCheckpoint->iGroupCutCases;
+	giNogoodCases = pstCheckpoint->iNogoodCases;
+	giRestartCases = pstCheckpoint->iRestartCases;
+	giSymmetryCases = pstCheckpoint->iSymmetryCases;
+}
+
+static char open_trace(
+	const char *pcFileName
+) {
+
+	TRACE_HEADER stHeader;
+
+	gpstTraceFile = fopen(pcFileName, "wb");
+	if (gpstTraceFile == NULL) {
+		printf("trace open failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	memset(&stHeader, '\0', sizeof(TRACE_HEADER));
+	memcpy(stHeader.pcMagic, TRACE_MAGIC, sizeof(stHeader.pcMagic));
+	stHeader.cVersion = TRACE_VERSION;
+	stHeader.cSize = gcSize;
+	stHeader.sStatusLen = sizeof(STATUS);
+
+	if (fwrite(&stHeader, sizeof(TRACE_HEADER), 1, gpstTraceFile) != 1) {
+		printf("trace write failed. file : %s, errno = %d\n", pcFileName, errno);
+		fclose(gpstTraceFile);
+		gpstTraceFile = NULL;
+		return RET_NG;
+	}
+
+	giTraceLen = 0;
+
+	return RET_OK;
+}
+
+static void add_trace(
+	char cEvent,
+	unsigned char cArg
+) {
+
+	pTRACE_REC pstRec;
+
+	if (giTraceLen >= TRACE_BUF_CNT) {
+		flush_trace();
+		if (gpstTraceFile == NULL) {
+			return;
+		}
+	}
+
+	pstRec = &gpstTraceBuf[giTraceLen++];
+	pstRec->cEvent = cEvent;
+	pstRec->cArg = cArg;
+	pstRec->sDepth = giDepth;
+}
+
+static void add_trace_root(
+	pSTATUS pstStatus
+) {
+
+	add_trace(TRACE_ROOT, 0);
+	flush_trace();
+
+	// ̔Ֆʂ͋L^̒ɂ̂܂ܒu
+	if (gpstTraceFile != NULL && fwrite(pstStatus, sizeof(STATUS), 1, gpstTraceFile) != 1) {
+		printf("trace write failed. errno = %d\n", errno);
+		fclose(gpstTraceFile);
+		gpstTraceFile = NULL;
+	}
+}
+
+static void flush_trace(void) {
+
+	// ȂȂL^߂āAT͑
+	if (giTraceLen > 0 && fwrite(gpstTraceBuf, sizeof(TRACE_REC), giTraceLen, gpstTraceFile) != (size_t) giTraceLen) {
+		printf("trace write failed. errno = %d\n", errno);
+		fclose(gpstTraceFile);
+		gpstTraceFile = NULL;
+	}
+
+	giTraceLen = 0;
+}
+
+static void close_trace(void) {
+
+	if (gpstTraceFile == NULL) {
+		return;
+	}
+
+	flush_trace();
+	if (gpstTraceFile != NULL && fclose(gpstTraceFile) != 0) {
+		printf("trace write failed. errno = %d\n", errno);
+	}
+	gpstTraceFile = NULL;
+}
+
+static int replay_trace(
+	const char *pcFileName
+) {
+
+	static const char *ppcEventNames[] = {
+		"root", "move", "back", "prune", "solved"
+	};
+	static const char *ppcDirNames[] = {
+		"right", "down", "left", "up"
+	};
+	TRACE_HEADER stHeader;
+	TRACE_REC stRec;
+	STATUS stStatus;
+	pSTATUS pstStates;
+	pLINK_PART pstLinkPart;
+	const unsigned char *pbStart;
+	const unsigned char *pbEnd;
+	const unsigned char *pbRec;
+	const unsigned char *pbNext;
+	const unsigned char *pbRoot;
+	const unsigned char *pbFrom;
+	const unsigned char *pbTo;
+	const unsigned char *pbChild;
+	const unsigned char *pbHot;
+	const unsigned char *pbHotEnd;
+	char *pcBuf;
+	long iLen;
+	long plEvents[TRACE_SOLVED + 1];
+	long plPrunes[PRUNE_CNT];
+	long plChildPrunes[PRUNE_CNT];
+	long plHotPrunes[PRUNE_CNT];
+	long iRecord;
+	long iRootRecord;
+	long iFromRecord;
+	long iChildRecord;
+	long iHotRecord;
+	long iMoves;
+	long iTotal;
+	long iChildMoves;
+	long iHotMoves;
+	int iChildCnt;
+	int iMaxDepth;
+	int iDepth;
+	int iLevel;
+
+	if (map_def(pcFileName, &pcBuf, &iLen) != RET_OK) {
+		printf("\n");
+		return EXIT_ERROR;
+	}
+
+	pbStart = (const unsigned char *) pcBuf + sizeof(TRACE_HEADER);
+	pbEnd = (const unsigned char *) pcBuf + iLen;
+	if (iLen >= (long) sizeof(TRACE_HEADER)) {
+		memcpy(&stHeader, pcBuf, sizeof(TRACE_HEADER));
+	}
+
+	if (
+		iLen < (long) sizeof(TRACE_HEADER)
+		|| memcmp(stHeader.pcMagic, TRACE_MAGIC, sizeof(stHeader.pcMagic)) != 0
+		|| stHeader.cVersion != TRACE_VERSION
+		|| stHeader.sStatusLen != sizeof(STATUS)
+		|| stHeader.cSize <= 0
+		|| stHeader.cSize > MAX_SIZE
+	) {
+		printf("%s : not a trace file.\n", pcFileName);
+		unmap_def(pcBuf, iLen);
+		return EXIT_ERROR;
+	}
+	gcSize = stHeader.cSize;
+
+	// ނƂɐÂ΂񑽂̒T؂T
+	memset(plEvents, '\0', sizeof(plEvents));
+	memset(plPrunes, '\0', sizeof(plPrunes));
+	iMaxDepth = 0;
+	pbRoot = NULL;
+	pbFrom = NULL;
+	pbTo = NULL;
+	iRootRecord = 0;
+	iFromRecord = 0;
+	iMoves = 0;
+	iTotal = -1;
+	iRecord = 0;
+
+	for (pbRec = pbStart; (pbNext = next_trace(pbRec, pbEnd, &stRec)) != NULL; pbRec = pbNext, iRecord++) {
+
+		if (stRec.cEvent == TRACE_ROOT) {
+			if (pbRoot != NULL && iMoves > iTotal) {
+				pbFrom = pbRoot;
+				pbTo = pbRec;
+				iFromRecord = iRootRecord;
+				iTotal = iMoves;
+			}
+			pbRoot = pbRec;
+			iRootRecord = iRecord;
+			iMoves = 0;
+		} else if (stRec.cEvent == TRACE_MOVE) {
+			iMoves++;
+		} else if (stRec.cEvent == TRACE_PRUNE) {
+			plPrunes[stRec.cArg]++;
+		}
+
+		plEvents[(int) stRec.cEvent]++;
+		if (stRec.sDepth > iMaxDepth) {
+			iMaxDepth = stRec.sDepth;
+		}
+	}
+
+	if (pbRec < pbEnd) {
+		printf("%s : trace broken at record %ld.\n", pcFileName, iRecord);
+	}
+	if (pbRoot != NULL && iMoves > iTotal) {
+		pbFrom = pbRoot;
+		pbTo = pbRec;
+		iFromRecord = iRootRecord;
+		iTotal = iMoves;
+	}
+
+	printf(
+		"trace:records %ld, roots %ld, moves %ld, backtracks %ld, prunes %ld, solutions %ld, max depth %d\n",
+		iRecord,
+		plEvents[TRACE_ROOT],
+		plEvents[TRACE_MOVE],
+		plEvents[TRACE_BACK],
+		plEvents[TRACE_PRUNE],
+		plEvents[TRACE_SOLVED],
+		iMaxDepth
+	);
+	printf("prunes:");
+	print_prunes(plPrunes);
+
+	// ̑؂炽ǂ (Ẑő̂̂֐i)A}ꂵƂo
+	if (pbFrom != NULL) {
+
+		next_trace(pbFrom, pbEnd, &stRec);
+		memcpy(&stStatus, pbFrom + sizeof(TRACE_REC), sizeof(STATUS));
+		iDepth = stRec.sDepth;
+
+		for (iLevel = 0; iLevel < TRACE_HOT_DEPTH && iDepth < MAX_DEPTH; iDepth++) {
+
+			iChildCnt = 0;
+			pbChild = NULL;
+			pbHot = NULL;
+			pbHotEnd = NULL;
+			iChildRecord = 0;
+			iHotRecord = 0;
+			iChildMoves = 0;
+			iHotMoves = 0;
+			iRecord = iFromRecord;
+
+			for (pbRec = pbFrom; pbRec <= pbTo; pbRec = pbNext, iRecord++) {
+
+				pbNext = NULL;
+				if (pbRec < pbTo) {
+					pbNext = next_trace(pbRec, pbEnd, &stRec);
+				}
+
+				// ؂͓[̎肩߂ŕ
+				if (
+					pbChild != NULL
+					&& (pbNext == NULL || (stRec.sDepth == iDepth && stRec.cEvent != TRACE_PRUNE && stRec.cEvent != TRACE_SOLVED))
+				) {
+					if (iChildMoves > iHotMoves) {
+						pbHot = pbChild;
+						pbHotEnd = pbRec;
+						iHotRecord = iChildRecord;
+						iHotMoves = iChildMoves;
+						memcpy(plHotPrunes, plChildPrunes, sizeof(plHotPrunes));
+					}
+					pbChild = NULL;
+				}
+
+				if (pbNext == NULL) {
+					break;
+				}
+
+				if (stRec.cEvent == TRACE_MOVE && stRec.sDepth == iDepth) {
+					iChildCnt++;
+					pbChild = pbRec;
+					iChildRecord = iRecord;
+					iChildMoves = 1;
+					memset(plChildPrunes, '\0', sizeof(plChildPrunes));
+				} else if (pbChild != NULL && stRec.cEvent == TRACE_MOVE) {
+					iChildMoves++;
+				} else if (pbChild != NULL && stRec.cEvent == TRACE_PRUNE) {
+					plChildPrunes[stRec.cArg]++;
+				}
+			}
+
+			if (pbHot == NULL) {
+				break;
+			}
+
+			next_trace(pbHot, pbEnd, &stRec);
+			if (iChildCnt > 1) {
+				pstLinkPart = stStatus.pstLinkParts + TRACE_PART(stRec.cArg);
+				printf(
+					"hot:depth %d, record %ld, link '%s' %s from [%d,%d], moves %ld (%ld%%) of %d tried, prunes ",
+					iDepth,
+					iHotRecord,
+					pstLinkPart->pcLinkName,
+					ppcDirNames[MOVE_DIR(stRec.cArg)],
+					pstLinkPart->stStart.cRow,
+					pstLinkPart->stStart.cCol,
+					iHotMoves,
+					(iTotal > 0) ? iHotMoves * 100 / iTotal : 0,
+					iChildCnt
+				);
+				print_prunes(plHotPrunes);
+				iLevel++;
+			}
+
+			replay_move(&stStatus, &stRec);
+			pbFrom = pbHot;
+			pbTo = pbHotEnd;
+			iFromRecord = iHotRecord;
+		}
+	}
+
+	// w̋L^܂ł̎ςݒāÂƂ̔Ֆʂo
+	if (giReplayAt >= 0) {
+
+		pstStates = malloc(sizeof(STATUS) * (MAX_DEPTH + 1));
+		if (pstStates == NULL) {
+			printf("malloc failed. errno = %d\n", errno);
+			unmap_def(pcBuf, iLen);
+			return EXIT_ERROR;
+		}
+
+		iDepth = -1;
+		iRecord = 0;
+		for (pbRec = pbStart; (pbNext = next_trace(pbRec, pbEnd, &stRec)) != NULL; pbRec = pbNext, iRecord++) {
+
+			if (stRec.cEvent == TRACE_ROOT) {
+				memcpy(pstStates, pbRec + sizeof(TRACE_REC), sizeof(STATUS));
+				iDepth = 0;
+			} else if (iDepth < 0) {
+				continue;
+			} else if (stRec.cEvent == TRACE_MOVE && stRec.sDepth < MAX_DEPTH) {
+				memcpy(&pstStates[stRec.sDepth + 1], &pstStates[stRec.sDepth], sizeof(STATUS));
+				replay_move(&pstStates[stRec.sDepth + 1], &stRec);
+				iDepth = stRec.sDepth + 1;
+			} else {
+				iDepth = stRec.sDepth;
+			}
+
+			if (iRecord == giReplayAt) {
+				break;
+			}
+		}
+
+		if (iRecord != giReplayAt || iDepth < 0) {
+			printf("record %ld not found.\n", giReplayAt);
+		} else {
+			printf("\nrecord:%ld, event:%s, depth:%d", iRecord, ppcEventNames[(int) stRec.cEvent], iDepth);
+			if (stRec.cEvent == TRACE_PRUNE) {
+				printf(", reason:%s", gppcPruneNames[(int) stRec.cArg]);
+			}
+			printf("\n");
+			print_grid(&pstStates[iDepth]);
+		}
+
+		free(pstStates);
+	}
+
+	unmap_def(pcBuf, iLen);
+
+	return EXIT_SOLVED;
+}
+
+static void replay_move(
+	pSTATUS pstStatus,
+	pTRACE_REC pstRec
+) {
+
+	pLINK_PART pstLinkPart;
+	NEIGHBOR stNeighbor;
+
+	pstLinkPart = pstStatus->pstLinkParts + TRACE_PART(pstRec->cArg);
+	stNeighbor.pstDir = &gpstDirections[MOVE_DIR(pstRec->cArg)];
+	stNeighbor.stPoint.cRow = pstLinkPart->stStart.cRow + stNeighbor.pstDir->cRowDelta;
+	stNeighbor.stPoint.cCol = pstLinkPart->stStart.cCol + stNeighbor.pstDir->cColDelta;
+
+	move_link(pstStatus, pstLinkPart, &stNeighbor);
+}
+
+static const unsigned char *next_trace(
+	const unsigned char *pbRec,
+	const unsigned char *pbEnd,
+	pTRACE_REC pstRec
+) {
+
+	const unsigned char *pbNext;
 
-		pstPrevLink = NULL;
+	// ̔Ֆʂ̌͑ĂȂ̂ŎʂĂǂ
+	if (pbEnd - pbRec < (long) sizeof(TRACE_REC)) {
+		return NULL;
+	}
+	memcpy(pstRec, pbRec, sizeof(TRACE_REC));
 
-		for (pstFrom = pstLinkDef->pstPoints; HAS_POINT(pstFrom); pstFrom++) {
+	pbNext = pbRec + sizeof(TRACE_REC);
+	if (pstRec->cEvent == TRACE_ROOT) {
+		pbNext += sizeof(STATUS);
+	}
 
-			pstTo = pstFrom + 1;
+	if (
+		pbNext > pbEnd
+		|| pstRec->cEvent > TRACE_SOLVED
+		|| pstRec->sDepth < 0
+		|| pstRec->sDepth > MAX_DEPTH
+		|| (pstRec->cEvent == TRACE_PRUNE && pstRec->cArg >= PRUNE_CNT)
+		|| (pstRec->cEvent == TRACE_MOVE && TRACE_PART(pstRec->cArg) >= MAX_PARTS)
+	) {
+		return NULL;
+	}
 
-			if (pstTo->cRow >= 0) {
+	return pbNext;
+}
 
-				if ((pstLinkPart - pstStatus->pstLinkParts) >= MAX_PARTS) {
-					printf("error : link parts count exceeded %d", MAX_PARTS);
-					return RET_NG;
-				}
+static void print_prunes(
+	long *plPrunes
+) {
 
-				memcpy(pstLinkPart->pcLinkName, pstLinkDef->pcLinkName, STAT_LEN);
-				memcpy(&(pstLinkPart->stStart), pstFrom, sizeof(POINT));
-				memcpy(&(pstLinkPart->stEnd), pstTo, sizeof(POINT));
+	const char *pcSep;
+	int i;
 
-				if (pstPrevLink == NULL) {
-					pstLinkPart->cPrev = -1;
-					open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, START_MARK);
-				} else {
-					pstPrevLink->cNext = pstLinkPart - pstStatus->pstLinkParts;
-					pstLinkPart->cPrev = pstPrevLink - pstStatus->pstLinkParts;
-					open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, MID_MARK);
-				}
+	// NȂR͏Ȃ
+	pcSep = "";
+	for (i = 0; i < PRUNE_CNT; i++) {
+		if (plPrunes[i] > 0) {
+			printf("%s%s:%ld", pcSep, gppcPruneNames[i], plPrunes[i]);
+			pcSep = ", ";
+		}
+	}
+	printf("\n");
+}
 
-				pstPrevLink = pstLinkPart;
-				pstLinkPart++;
+static void add_profile_node(void) {
 
-			} else {
-				pstPrevLink->cNext = -1;
-				open_stat(pstStatus, pstFrom, pstLinkDef->pcLinkName, END_MARK);
+	gpstDepthBins[giDepth].iNodes++;
+	get_fill_bin()->iNodes++;
+}
+
+static void add_profile_prune(
+	char cReason
+) {
+
+	gpstDepthBins[giDepth].plPrunes[(int) cReason]++;
+	get_fill_bin()->plPrunes[(int) cReason]++;
+}
+
+static pPROFILE_BIN get_fill_bin(void) {
+
+	int iFill;
+
+	// 育Ƃ 1 }X܂̂ŁAŖ܂Ăɐ[𑫂΂悢
+	iFill = (giRootFilled + giDepth) * PROFILE_FILL_CNT / (gcSize * gcSize);
+	if (iFill >= PROFILE_FILL_CNT) {
+		iFill = PROFILE_FILL_CNT - 1;
+	}
+
+	return &gpstFillBins[iFill];
+}
+
+static int get_filled(
+	pSTATUS pstStatus
+) {
+
+	POINT stPoint;
+	int iFilled;
+
+	iFilled = 0;
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+			if (has_stat(pstStatus, &stPoint) == RET_OK) {
+				iFilled++;
 			}
 		}
 	}
 
-	for (cRow = 0; cRow < gcSize; cRow++) {
-		for (cCol = 0; cCol < gcSize; cCol++) {
-			strcpy(pstStatus->pppcHwalls[cRow][cCol], H_WALL);
-			strcpy(pstStatus->pppcVwalls[cRow][cCol], V_WALL);
+	return iFilled;
+}
+
+static void tune_forward1(
+	int iDepth
+) {
+
+	pPROFILE_BIN pstBin;
+	long iNodeNsec;
+
+	pstBin = &gpstDepthBins[iDepth];
+	if (pstBin->iNodes == 0) {
+		return;
+	}
+
+	// Ƃ}ЂƂŐm[hׂ̒ȂƂ݂āA荂[ł͈Ȍ㒲ׂȂ
+	iNodeNsec = pstBin->iPartitionNsec / pstBin->iNodes;
+	if (pstBin->iForward1Nsec > pstBin->iForward1Prunes * TUNE_SAVED_NODES * iNodeNsec) {
+		gpcFd1Off[iDepth] = FLG_ON;
+	}
+}
+
+static char write_profile(
+	const char *pcFileName
+) {
+
+	FILE *pstFile;
+	time_t tNowTime;
+	int i;
+
+	pstFile = fopen(pcFileName, "w");
+	if (pstFile == NULL) {
+		printf("profile open failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
+	}
+
+	time(&tNowTime);
+	fprintf(
+		pstFile,
+		"{\"size\":%d,\"nodes\":%ld,\"elapsed\":%ld,\"root_filled\":%d,\"auto_tune\":%s,\"depths\":[",
+		gcSize,
+		giNodeCases,
+		(long) difftime(tNowTime, gtStartTime),
+		giRootFilled,
+		(gcAutoTune == FLG_ON) ? "true" : "false"
+	);
+
+	// m[ĥȂ[͏Ȃ
+	for (i = 0; i <= MAX_DEPTH; i++) {
+		if (gpstDepthBins[i].iNodes == 0) {
+			continue;
 		}
+		fprintf(pstFile, "%s{\"depth\":%d,", (i > 0) ? "," : "", i);
+		write_profile_bin(pstFile, &gpstDepthBins[i]);
+		fprintf(pstFile, ",\"forward1\":%s}", (gpcFd1Off[i] == FLG_ON) ? "false" : "true");
+	}
+
+	fprintf(pstFile, "],\"fills\":[");
+	for (i = 0; i < PROFILE_FILL_CNT; i++) {
+		fprintf(
+			pstFile,
+			"%s{\"from\":%d,\"to\":%d,",
+			(i > 0) ? "," : "",
+			i * 100 / PROFILE_FILL_CNT,
+			(i + 1) * 100 / PROFILE_FILL_CNT
+		);
+		write_profile_bin(pstFile, &gpstFillBins[i]);
+		fprintf(pstFile, "}");
+	}
+	fprintf(pstFile, "]}\n");
+
+	if (fclose(pstFile) != 0) {
+		printf("profile write failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
 	}
 
 	return RET_OK;
 }
 
-static void close_connected_links(
-	pSTATUS pstStatus
+static void write_profile_bin(
+	FILE *pstFile,
+	pPROFILE_BIN pstBin
 ) {
 
-	pLINK_PART pstLinkPart;
+	int i;
 
-	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
-		close_connected_link(pstStatus, pstLinkPart);
+	fprintf(pstFile, "\"nodes\":%ld,\"prunes\":{", pstBin->iNodes);
+	for (i = 0; i < PRUNE_CNT; i++) {
+		fprintf(pstFile, "%s\"%s\":%ld", (i > 0) ? "," : "", gppcPruneNames[i], pstBin->plPrunes[i]);
 	}
+	fprintf(
+		pstFile,
+		"},\"partition_usec\":%ld,\"forward1_usec\":%ld,\"forward1_calls\":%ld,\"forward1_prunes\":%ld",
+		pstBin->iPartitionNsec / 1000,
+		pstBin->iForward1Nsec / 1000,
+		pstBin->iForward1Calls,
+		pstBin->iForward1Prunes
+	);
 }
 
-static void answer_gen(
-	pSTATUS pstStatus
+static char save_state(
+	const char *pcFileName
 ) {
-	pLINK_PART pstLinkPart;
-	POINT stPoint;
 
-	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
-	pNEIGHBOR pstNeighbor;
-	pDIRECTION pstDir;
+	char pcTmpName[FILENAME_MAX];
+	FILE *pstFile;
 
-	STATUS stStatus2;
-	POINT stPoint2;
-	pSTATUS pstStatus2;
-	pLINK_PART pstLinkPart2;
+	memcpy(gstIncrState.pcMagic, INCR_MAGIC, sizeof(gstIncrState.pcMagic));
+	gstIncrState.cVersion = INCR_VERSION;
+
+	// ȂƂ͑Ỏ̏Ĉ߂Ɏc
+	if (gcStopReason == STOP_SOLVED) {
+		gstIncrState.cSize = gcSize;
+		gstIncrState.cSolved = FLG_ON;
+		memcpy(gstIncrState.pstLinkDefs, gpstLinkDefs, sizeof(gstIncrState.pstLinkDefs));
+		memcpy(&(gstIncrState.stSolution), &gstSolution, sizeof(STATUS));
+	}
 
-	pstLinkPart = get_open_link(pstStatus);
+	gstIncrState.lDefHash = get_def_hash();
+	memcpy(gstIncrState.pstNogoods, gpstNogoods, sizeof(gpstNogoods));
 
-	if (pstLinkPart == NULL) {
-		DEBUG_PRINTF("\n----- !!!!!solved!!!!! -----");
-		print_status(pstStatus);
-		exit(0);
+	snprintf(pcTmpName, sizeof(pcTmpName), "%s.tmp", pcFileName);
+	pstFile = fopen(pcTmpName, "wb");
+	if (pstFile == NULL) {
+		printf("state open failed. file : %s, errno = %d\n", pcTmpName, errno);
+		return RET_NG;
 	}
 
-	if (check_partition(pstStatus) != RET_OK) {
-		return;
+	if (fwrite(&gstIncrState, sizeof(gstIncrState), 1, pstFile) != 1) {
+		printf("state write failed. file : %s, errno = %d\n", pcTmpName, errno);
+		fclose(pstFile);
+		return RET_NG;
 	}
 
-	if (check_forward1(pstStatus) != RET_OK) {
-		return;
+	fclose(pstFile);
+
+	if (rename(pcTmpName, pcFileName) != 0) {
+		printf("state rename failed. file : %s, errno = %d\n", pcFileName, errno);
+		return RET_NG;
 	}
 
-	print_progress(pstStatus);
+	return RET_OK;
+}
 
-	stPoint = pstLinkPart->stStart;
-	get_neighbors(&stPoint, pstNeighbors);
+static char load_state(
+	const char *pcFileName
+) {
 
-	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+	FILE *pstFile;
 
-		stPoint2 = pstNeighbor->stPoint;
-		pstDir = pstNeighbor->pstDir;
+	memset(&gstIncrState, '\0', sizeof(gstIncrState));
 
-		if (has_stat(pstStatus, &stPoint2) == RET_OK) {
-			continue;
+	// ͏ԃt@CȂ̂ŕʂɉ
+	pstFile = fopen(pcFileName, "rb");
+	if (pstFile == NULL) {
+		return RET_NG;
+	}
+
+	if (
+		fread(&gstIncrState, sizeof(gstIncrState), 1, pstFile) != 1
+		|| memcmp(gstIncrState.pcMagic, INCR_MAGIC, sizeof(gstIncrState.pcMagic)) != 0
+		|| gstIncrState.cVersion != INCR_VERSION
+	) {
+		printf("%s : not a state file.\n", pcFileName);
+		fclose(pstFile);
+		memset(&gstIncrState, '\0', sizeof(gstIncrState));
+		return RET_NG;
+	}
+
+	fclose(pstFile);
+
+	// s\̓N̔ԍɈˑ̂ŁA`̂Ƃp
+	if (gstIncrState.lDefHash == get_def_hash()) {
+		memcpy(gpstNogoods, gstIncrState.pstNogoods, sizeof(gpstNogoods));
+	}
+
+	return RET_OK;
+}
+
+static void print_grid(
+	pSTATUS pstStatus
+) {
+
+	render_grid(pstStatus);
+	flush_render();
+}
+
+static void render_grid(
+	pSTATUS pstStatus
+) {
+
+	POINT stPoint;
+	NEIGHBOR stNeighbor;
+	char cDir;
+
+	// ǂƖ̓}X̐iތgݗĂ
+	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
+		if (stPoint.cRow > 0) {
+			stNeighbor.pstDir = &gpstDirections[DIR_UP];
+			stNeighbor.stPoint.cRow = stPoint.cRow - 1;
+			for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+				if (stPoint.cCol > 0) {
+					render_char('+');
+				}
+				stNeighbor.stPoint.cCol = stPoint.cCol;
+				cDir = get_line_dir(pstStatus, &stPoint, &stNeighbor);
+				render_str(cDir == DIR_NONE ? H_WALL : gpstDirections[(int) cDir].pcDirMark);
+			}
+			render_char('\n');
 		}
+		stNeighbor.pstDir = &gpstDirections[DIR_LEFT];
+		stNeighbor.stPoint.cRow = stPoint.cRow;
+		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+			if (stPoint.cCol > 0) {
+				stNeighbor.stPoint.cCol = stPoint.cCol - 1;
+				cDir = get_line_dir(pstStatus, &stPoint, &stNeighbor);
+				render_str(cDir == DIR_NONE ? V_WALL : gpstDirections[(int) cDir].pcDirMark);
+			}
+			if (has_stat(pstStatus, &stPoint) == RET_OK) {
+				render_pad(get_stat(pstStatus, &stPoint), STAT_LEN, FLG_ON);
+			} else if (is_fd1_point(pstStatus, &stPoint) == RET_OK) {
+				render_str(FD1_MARK);
+			} else {
+				render_str("   ");
+			}
+		}
+		render_char('\n');
+	}
+}
 
-		if (check_branch(pstStatus, &stPoint2, pstLinkPart->pcLinkName) != RET_OK) {
-			continue;
+static void print_status(
+	pSTATUS pstStatus
+) {
+
+	time_t tNowTime;
+	int iElapsed;
+	int i;
+
+	time(&tNowTime);
+	iElapsed = (int) difftime(tNowTime, gtStartTime);
+
+	render_str("\ntm:");
+	render_int(iElapsed / 3600, 2);
+	render_char(':');
+	render_int(iElapsed / 60 % 60, 2);
+	render_char(':');
+	render_int(iElapsed % 60, 2);
+
+	for (i = 0; i < COUNTER_CNT; i++) {
+		render_str(", ");
+		render_str(gppcCounterNames[i]);
+		render_char(':');
+		render_int(*gppiCounters[i], 1);
+	}
+	render_char('\n');
+
+	// Ֆʂ܂ňxɏo
+	render_grid(pstStatus);
+	flush_render();
+}
+
+static void print_solution(void) {
+
+	switch (gcFormat) {
+	case FORMAT_DIRS:
+		render_dirs();
+		break;
+	case FORMAT_JSON:
+		render_json();
+		break;
+	case FORMAT_BINARY:
+		if (write_bin(&gstFormatWriter, get_bin_result()) != RET_OK) {
+			printf("solution can not be written.\n");
+		}
+		return;
+	default:
+		if (gcStopReason == STOP_SOLVED) {
+			print_status(&gstSolution);
 		}
+		print_result();
+		return;
+	}
+
+	flush_render();
+}
+
+static void render_dirs(void) {
+
+	static const char pcDirChars[] = "rdlu";
+
+	char ppcCells[MAX_SIZE][MAX_SIZE];
+	pLINK_DEF pstLinkDef;
+	PATH_DEF stPathDef;
+	pPOINT pstPoint;
+	char cDir;
+	char cRow;
+	char cCol;
 
-		memcpy(&stStatus2, pstStatus, sizeof(STATUS));
-		pstLinkPart2 = get_open_link(&stStatus2);
+	if (gcStopReason != STOP_SOLVED) {
+		render_str("-\n");
+		return;
+	}
 
-		close_stat(&stStatus2, &stPoint);
-		set_direction(&stStatus2, &stPoint, pstDir);
-		open_stat(&stStatus2, &stPoint2, pstLinkPart2->pcLinkName, NULL);
+	// }XƂɎ̃}Xւ̌AI_ '*'AgȂ}X '.'
+	memset(ppcCells, '.', sizeof(ppcCells));
+	for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
 
-		pstLinkPart2->stStart = stPoint2;
-		close_connected_link(&stStatus2, pstLinkPart2);
+		if (get_solution_path(&gstSolution, pstLinkDef, &stPathDef) != RET_OK) {
+			continue;
+		}
 
-		answer_gen(&stStatus2);
+		for (pstPoint = stPathDef.pstPoints; HAS_POINT((pstPoint + 1)); pstPoint++) {
+			for (cDir = 0; cDir < NEIGHBOR_CNT; cDir++) {
+				if (
+					pstPoint->cRow + gpstDirections[(int) cDir].cRowDelta == pstPoint[1].cRow
+					&& pstPoint->cCol + gpstDirections[(int) cDir].cColDelta == pstPoint[1].cCol
+				) {
+					break;
+				}
+			}
+			ppcCells[(int) pstPoint->cRow][(int) pstPoint->cCol] = pcDirChars[(int) cDir];
+		}
+		ppcCells[(int) pstPoint->cRow][(int) pstPoint->cCol] = '*';
 	}
 
+	for (cRow = 0; cRow < gcSize; cRow++) {
+		if (cRow > 0) {
+			render_char('/');
+		}
+		for (cCol = 0; cCol < gcSize; cCol++) {
+			render_char(ppcCells[(int) cRow][(int) cCol]);
+		}
+	}
+	render_char('\n');
 }
 
-static char check_branch(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	char *pcLinkName
-) {
+static void render_json(void) {
 
-	char pcClosedStat[STAT_LEN + 1];
+	static const char *ppcResults[] = {
+		"unsat",
+		"solved",
+		"budget exhausted (nodes)",
+		"budget exhausted (time)",
+		"budget exhausted (memory)",
+		"canceled"
+	};
 
-	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
-	pNEIGHBOR pstNeighbor;
-	char *pcStat;
+	time_t tNowTime;
+	pLINK_DEF pstLinkDef;
+	PATH_DEF stPathDef;
+	pPOINT pstPoint;
+	int i;
 
-	sprintf(pcClosedStat, "%2s%1s", pcLinkName, CLOSE_MARK);
+	time(&tNowTime);
 
-	get_neighbors(pstPoint, pstNeighbors);
-	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+	render_str("{\"size\":");
+	render_int(gcSize, 1);
+	render_str(",\"result\":\"");
+	render_str(ppcResults[(int) gcStopReason]);
+	render_str("\",\"nodes\":");
+	render_int(giNodeCases, 1);
+	render_str(",\"elapsed\":");
+	render_int((long) difftime(tNowTime, gtStartTime), 1);
+	if (gcCount == FLG_ON) {
+		render_str(",\"solutions\":");
+		render_int(giSolutionCases, 1);
+	}
 
-		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+	// }̓͌o߂̍sƓOŏo
+	render_str(",\"counters\":{");
+	for (i = 0; i < COUNTER_CNT; i++) {
+		if (i > 0) {
+			render_char(',');
+		}
+		render_char('"');
+		render_str(gppcCounterNames[i]);
+		render_str("\":");
+		render_int(*gppiCounters[i], 1);
+	}
+	render_char('}');
 
-		if (strcmp(pcStat, pcClosedStat) == 0) {
-			giBranchErrCases++;
-			DEBUG_PRINTF("\n----- branch of '%s' at [%d, %d] -----\n", pcLinkName, pstPoint->cRow, pstPoint->cCol);
-			DEBUG_PRINT_GRID(pstStatus);
-			return RET_NG;
+	if (gcProfile == FLG_ON) {
+		render_profile();
+	}
+
+	// Ƃ̓NƂɎn_炽ǂ}Xׂ
+	if (gcStopReason == STOP_SOLVED) {
+		render_str(",\"paths\":{");
+		for (pstLinkDef = gpstLinkDefs; HAS_LINK(pstLinkDef); pstLinkDef++) {
+			if (pstLinkDef > gpstLinkDefs) {
+				render_char(',');
+			}
+			render_char('"');
+			render_str(pstLinkDef->pcLinkName);
+			render_str("\":[");
+			if (get_solution_path(&gstSolution, pstLinkDef, &stPathDef) == RET_OK) {
+				for (pstPoint = stPathDef.pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+					if (pstPoint > stPathDef.pstPoints) {
+						render_char(',');
+					}
+					render_char('[');
+					render_int(pstPoint->cRow, 1);
+					render_char(',');
+					render_int(pstPoint->cCol, 1);
+					render_char(']');
+				}
+			}
+			render_char(']');
+		}
+		render_char('}');
+	}
+
+	render_str("}\n");
+}
+
+static void render_profile(void) {
+
+	static const char *ppcNames[] = {
+		"partition_usec", "forward1_usec", "forward1_calls", "forward1_prunes"
+	};
+
+	long plValues[4];
+	int iMaxDepth;
+	int iOffCnt;
+	int i;
+
+	// [Ƃ̕\ (--profile ̃t@C) 𑫂킹ڂ
+	memset(plValues, '\0', sizeof(plValues));
+	iMaxDepth = 0;
+	iOffCnt = 0;
+	for (i = 0; i <= MAX_DEPTH; i++) {
+		plValues[0] += gpstDepthBins[i].iPartitionNsec;
+		plValues[1] += gpstDepthBins[i].iForward1Nsec;
+		plValues[2] += gpstDepthBins[i].iForward1Calls;
+		plValues[3] += gpstDepthBins[i].iForward1Prunes;
+		if (gpstDepthBins[i].iNodes > 0) {
+			iMaxDepth = i;
+		}
+		if (gpcFd1Off[i] == FLG_ON) {
+			iOffCnt++;
 		}
 	}
+	plValues[0] /= 1000;
+	plValues[1] /= 1000;
+
+	render_str(",\"profile\":{\"root_filled\":");
+	render_int(giRootFilled, 1);
+	render_str(",\"max_depth\":");
+	render_int(iMaxDepth, 1);
+	for (i = 0; i < 4; i++) {
+		render_str(",\"");
+		render_str(ppcNames[i]);
+		render_str("\":");
+		render_int(plValues[i], 1);
+	}
+	render_str(",\"auto_tune\":");
+	render_str((gcAutoTune == FLG_ON) ? "true" : "false");
+	render_str(",\"forward1_off\":");
+	render_int(iOffCnt, 1);
+	render_char('}');
+}
+
+static void render_char(
+	char c
+) {
 
-	return RET_OK;
+	if (giRenderLen >= RENDER_BUF_LEN) {
+		flush_render();
+	}
+	gpcRender[giRenderLen++] = c;
 }
 
-static char check_partition(
-	pSTATUS pstStatus
+static void render_str(
+	const char *pcStr
 ) {
 
-	STATUS stStatus2;
-	POINT stPoint;
-	char ppcExitPoints[MAX_SIZE][MAX_SIZE];
-	char cPartActive;
-	pLINK_PART pstLinkPart;
-
-	memcpy(&stStatus2, pstStatus, sizeof(STATUS));
+	while (*pcStr != '\0') {
+		render_char(*(pcStr++));
+	}
+}
 
-	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
-		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+static void render_pad(
+	const char *pcStr,
+	int iWidth,
+	char cLeft
+) {
 
-			if (has_stat(&stStatus2, &stPoint) == RET_OK) {
-				continue;
-			}
+	int iLen;
 
-			memset(ppcExitPoints, '\0', sizeof(ppcExitPoints));
-			if (fill_partition(&stStatus2, &stPoint, ppcExitPoints) != RET_OK) {
-				return RET_NG;
-			}
+	// printf  "%3s"  "%-3s" ɍ킹ċ󔒂Ŗ߂
+	iLen = strlen(pcStr);
+	if (cLeft == FLG_ON) {
+		render_str(pcStr);
+	}
+	for (; iLen < iWidth; iLen++) {
+		render_char(' ');
+	}
+	if (cLeft == FLG_OFF) {
+		render_str(pcStr);
+	}
+}
 
-			cPartActive = FLG_OFF;
+static void render_int(
+	long iValue,
+	int iWidth
+) {
 
-			for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
-				if (pstLinkPart->cClose == FLG_ON) {
-					continue;
-				}
-				if (ppcExitPoints[pstLinkPart->stStart.cRow][pstLinkPart->stStart.cCol] != FLG_ON) {
-					continue;
-				}
-				if (ppcExitPoints[pstLinkPart->stEnd.cRow][pstLinkPart->stEnd.cCol] != FLG_ON) {
-					continue;
-				}
-				cPartActive = FLG_ON;
-				stStatus2.pstLinkParts[pstLinkPart - pstStatus->pstLinkParts].cClose = FLG_ON;
+	char pcDigits[24];
+	int iLen;
 
-			}
+	if (iValue < 0) {
+		render_char('-');
+		iValue = -iValue;
+	}
 
-//			DEBUG_PRINTF("  fill : [%d, %d], exit : ", stPoint.cRow, stPoint.cCol);
-//			DEBUG_PRINT_EXIT(ppcExitPoints);
-//			DEBUG_PRINTF(" active : %d\n", cPartActive);
+	// Ȃ 0 Ŗ߂ ("%02d" Ɠ)
+	iLen = 0;
+	do {
+		pcDigits[iLen++] = '0' + iValue % 10;
+		iValue /= 10;
+	} while (iValue > 0 || iLen < iWidth);
 
-			// NȂV}
-			if (cPartActive != FLG_ON) {
-				giDeadPartitionCases++;
-				DEBUG_PRINTF("\n----- dead partition at [%d, %d] -----\n", stPoint.cRow, stPoint.cCol);
-				DEBUG_PRINT_GRID(&stStatus2);
-				return RET_NG;
-			}
-		}
+	while (--iLen >= 0) {
+		render_char(pcDigits[iLen]);
 	}
+}
 
-	// Bs\ȃNꍇ
-	pstLinkPart = get_open_link(&stStatus2);
-	if (pstLinkPart != NULL) {
-		giSplitLinkCases++;
-		DEBUG_PRINTF("\n----- split link ");
-		DEBUG_PRINT_LINK(pstLinkPart);
-		DEBUG_PRINTF(" -----\n");
-		DEBUG_PRINT_GRID(&stStatus2);
-		return RET_NG;
-	}
+static void flush_render(void) {
 
-	return RET_OK;
+	// printf ̏o͂ƏւȂ悤Astdio ɂ܂Ƃ߂ēn
+	fwrite(gpcRender, 1, giRenderLen, stdout);
+	giRenderLen = 0;
 }
 
-static char fill_partition(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	char ppcExitPoints[MAX_SIZE][MAX_SIZE]
+static int run_server(
+	const char *pcSocketPath
 ) {
 
-	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
-	pNEIGHBOR pstNeighbor;
-	char cFreeCnt;
-	char *pcStat;
-
-	cFreeCnt = 0;
-	get_neighbors(pstPoint, pstNeighbors);
-	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+	int iListenFd;
+	struct sockaddr_un stAddr;
+	struct pollfd pstPolls[1 + MAX_WORKERS + MAX_CLIENTS];
+	pWORKER pstWorker;
+	pCONNECTION pstConn;
+	int i;
 
-		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+	if (strlen(pcSocketPath) >= sizeof(stAddr.sun_path)) {
+		printf("%s : socket path too long.\n", pcSocketPath);
+		return EXIT_ERROR;
+	}
 
-		if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
-			continue;
-		}
+	iListenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (iListenFd < 0) {
+		printf("socket failed. errno = %d\n", errno);
+		return EXIT_ERROR;
+	}
 
-		cFreeCnt++;
+	memset(&stAddr, '\0', sizeof(stAddr));
+	stAddr.sun_family = AF_UNIX;
+	strcpy(stAddr.sun_path, pcSocketPath);
+	unlink(pcSocketPath);
 
-		if (atoi(pcStat) > 0) {
-			ppcExitPoints[pstNeighbor->stPoint.cRow][pstNeighbor->stPoint.cCol] = FLG_ON;
-		}
+	if (
+		bind(iListenFd, (struct sockaddr *) &stAddr, sizeof(stAddr)) != 0
+		|| listen(iListenFd, SERVER_BACKLOG) != 0
+	) {
+		printf("bind failed. socket : %s, errno = %d\n", pcSocketPath, errno);
+		close(iListenFd);
+		return EXIT_ERROR;
 	}
 
-	//܏HɂȂĂ
-	if (cFreeCnt <= 1) {
-		giDeadEndCases++;
-		DEBUG_PRINTF("\n----- dead end at [%d, %d] -----\n",  pstPoint->cRow, pstPoint->cCol);
-		DEBUG_PRINT_GRID(pstStatus);
-		return RET_NG;
+	// [J[ԂŋL铝v
+	gpstServerStats = mmap(NULL, sizeof(SERVER_STATS), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+	if (gpstServerStats == MAP_FAILED) {
+		printf("mmap failed. errno = %d\n", errno);
+		close(iListenFd);
+		unlink(pcSocketPath);
+		return EXIT_ERROR;
 	}
+	memset(gpstServerStats, '\0', sizeof(SERVER_STATS));
+	time(&(gpstServerStats->tStartTime));
 
-	fill_stat(pstStatus, pstPoint);
+	gcQuiet = FLG_ON;
+	gpcCheckpointFile = NULL;
+	gpcIncrementalFile = NULL;
+	signal(SIGPIPE, SIG_IGN);
+	set_signal(SIGINT, on_shutdown);
+	set_signal(SIGTERM, on_shutdown);
 
-	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
-		if (has_stat(pstStatus, &(pstNeighbor->stPoint)) == RET_OK) {
-			continue;
-		}
+	printf("listening on %s with %d workers\n", pcSocketPath, giWorkers);
+	fflush(stdout);
 
-		if (fill_partition(pstStatus, &(pstNeighbor->stPoint), ppcExitPoints) != RET_OK) {
-			return RET_NG;
-		}
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		gpstConnections[i].cState = CONN_FREE;
 	}
 
-	return RET_OK;
-}
+	// \͐evZXō쐬ς݂Ȃ̂Ń[J[͂̂܂܎g
+	for (i = 0; i < giWorkers; i++) {
+		gpstWorkers[i].iFd = -1;
+	}
+	for (i = 0; i < giWorkers; i++) {
+		start_worker(i, iListenFd);
+	}
 
-static char check_forward1(
-	pSTATUS pstStatus
-) {
-	char *pcFd1Flag;
-	POINT stPoint;
+	// ڑ͐evZX܂Ƃ߂đ҂Av󂢂[J[ɓn
+	while (gcShutdown == FLG_OFF) {
 
-	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
-		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
-			if (is_fd1_point(pstStatus, &stPoint) != RET_OK) {
-				continue;
+		pstPolls[0].fd = (gpstServerStats->iClients < MAX_CLIENTS) ? iListenFd : -1;
+		pstPolls[0].events = POLLIN;
+		for (i = 0; i < giWorkers; i++) {
+			pstPolls[1 + i].fd = gpstWorkers[i].iFd;
+			pstPolls[1 + i].events = POLLIN;
+		}
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			pstConn = &(gpstConnections[i]);
+			pstPolls[1 + giWorkers + i].fd = (pstConn->cState == CONN_IDLE) ? pstConn->stClient.iFd : -1;
+			pstPolls[1 + giWorkers + i].events = POLLIN;
+		}
+
+		if (poll(pstPolls, 1 + giWorkers + MAX_CLIENTS, -1) < 0) {
+			continue;
+		}
+
+		for (i = 0; i < giWorkers; i++) {
+			if (pstPolls[1 + i].revents != 0) {
+				finish_request(i, iListenFd);
 			}
-			if (check_forward1_at(pstStatus, &stPoint) != RET_OK) {
-				return RET_NG;
+		}
+		for (i = 0; i < MAX_CLIENTS; i++) {
+			if (pstPolls[1 + giWorkers + i].revents != 0 && gpstConnections[i].cState == CONN_IDLE) {
+				read_connection(i);
 			}
 		}
+		if (pstPolls[0].revents != 0) {
+			accept_connection(iListenFd);
+		}
+
+		dispatch_requests();
 	}
 
-	return RET_OK;
-}
+	for (i = 0; i < giWorkers; i++) {
+		pstWorker = &(gpstWorkers[i]);
+		if (pstWorker->iPid > 0) {
+			kill(pstWorker->iPid, SIGTERM);
+		}
+		if (pstWorker->iFd >= 0) {
+			close(pstWorker->iFd);
+		}
+	}
+	while (wait(NULL) > 0) {
+	}
 
-static char check_forward1_at(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
-) {
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (gpstConnections[i].cState != CONN_FREE) {
+			close_connection(i);
+		}
+	}
 
-	STATUS stStatus2;
-	POINT stPoint;
-	char ppcExitPoints[MAX_SIZE][MAX_SIZE];
-	pLINK_PART pstLinkPart;
-	char cActiveCnt;
+	close(iListenFd);
+	unlink(pcSocketPath);
+	munmap(gpstServerStats, sizeof(SERVER_STATS));
 
-	memcpy(&stStatus2, pstStatus, sizeof(STATUS));
-	set_stat(&stStatus2, pstPoint, "0", CLOSE_MARK);
+	return EXIT_SUCCESS;
+}
 
-	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
-		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
+static void on_shutdown(
+	int iSignal
+) {
+	gcShutdown = FLG_ON;
+}
 
-			if (has_stat(&stStatus2, &stPoint) == RET_OK) {
-				continue;
-			}
+static void start_worker(
+	int iWorker,
+	int iListenFd
+) {
 
-			memset(ppcExitPoints, '\0', sizeof(ppcExitPoints));
-			fill_partition_forward1(&stStatus2, &stPoint, ppcExitPoints);
+	int piFds[2];
+	pWORKER pstWorker;
+	int i;
 
-//			DEBUG_PRINTF("  forward : [%d, %d], exit : ", stPoint.cRow, stPoint.cCol);
-//			DEBUG_PRINT_EXIT(ppcExitPoints);
-//			DEBUG_PRINTF("\n");
+	pstWorker = &(gpstWorkers[iWorker]);
+	pstWorker->iPid = -1;
+	pstWorker->iFd = -1;
+	pstWorker->iConn = -1;
 
-			if (memcmp(ppcExitPoints, gppcZeroExitPoints, sizeof(ppcExitPoints)) == 0) {
-				giFd1DeadPartitionCases++
-				DEBUG_PRINTF(
-					"\n----- dead partition by [%d, %d] at [%d, %d] -----\n",
-					pstPoint->cRow, pstPoint->cCol, stPoint.cRow, stPoint.cCol
-				);
-				DEBUG_PRINT_GRID(&stStatus2);
-				return RET_NG;
-			}
+	// v̎󂯓n͋؂̕ۂ\Pbgōs
+	if (socketpair(AF_UNIX, SOCK_SEQPACKET, 0, piFds) != 0) {
+		printf("socketpair failed. errno = %d\n", errno);
+		return;
+	}
 
-			for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
-				if (pstLinkPart->cClose == FLG_ON) {
-					continue;
-				}
-				if (ppcExitPoints[pstLinkPart->stStart.cRow][pstLinkPart->stStart.cCol] != FLG_ON) {
-					continue;
-				}
-				if (ppcExitPoints[pstLinkPart->stEnd.cRow][pstLinkPart->stEnd.cCol] != FLG_ON) {
-					continue;
-				}
-				stStatus2.pstLinkParts[pstLinkPart - pstStatus->pstLinkParts].cClose = FLG_ON;
-			}
+	pstWorker->iPid = fork();
+	if (pstWorker->iPid != 0) {
+		close(piFds[1]);
+		if (pstWorker->iPid < 0) {
+			printf("fork failed. errno = %d\n", errno);
+			close(piFds[0]);
+			return;
 		}
+		pstWorker->iFd = piFds[0];
+		return;
 	}
 
-	cActiveCnt = 0;
-	for (pstLinkPart = stStatus2.pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
-		if (pstLinkPart->cClose == FLG_ON) {
-			continue;
+	// evZX̎ڑcƁAeĂNCAgɐؒf`Ȃ
+	close(piFds[0]);
+	close(iListenFd);
+	for (i = 0; i < giWorkers; i++) {
+		if (gpstWorkers[i].iFd >= 0) {
+			close(gpstWorkers[i].iFd);
 		}
-		cActiveCnt++;
-		if (cActiveCnt > 1) {
-			giMultiSplitCases++
-			DEBUG_PRINTF("\n----- multiple split at [%d, %d] for ", pstPoint->cRow, pstPoint->cCol);
-			DEBUG_PRINT_LINKS(stStatus2.pstLinkParts);
-			DEBUG_PRINTF(" -----\n");
-			DEBUG_PRINT_GRID(&stStatus2);
-			return RET_NG;
+	}
+	for (i = 0; i < MAX_CLIENTS; i++) {
+		if (gpstConnections[i].cState != CONN_FREE) {
+			close(gpstConnections[i].stClient.iFd);
 		}
 	}
 
-	return RET_OK;
+	set_signal(SIGINT, on_signal);
+	set_signal(SIGTERM, on_signal);
+
+	worker_loop(piFds[1]);
+	_exit(EXIT_SUCCESS);
 }
 
-static void fill_partition_forward1(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	char ppcExitPoints[MAX_SIZE][MAX_SIZE]
+static void worker_loop(
+	int iCtrlFd
 ) {
 
-	NEIGHBOR pstNeighbors[NEIGHBOR_CNT + 1];
-	pNEIGHBOR pstNeighbor;
-	char *pcStat;
+	CLIENT stClient;
+	char pcLine[LINE_BUF_LEN + 1];
+	int iStdoutFd;
 
-	fill_stat(pstStatus, pstPoint);
+	iStdoutFd = dup(STDOUT_FILENO);
 
-	get_neighbors(pstPoint, pstNeighbors);
-	for (pstNeighbor = pstNeighbors; HAS_NEIGHBOR(pstNeighbor); pstNeighbor++) {
+	// 1 ƂɎc̎Mς݂̕e֕ԂA̗v҂
+	while (gcCancel == FLG_OFF && recv_handoff(iCtrlFd, &stClient, &(stClient.iFd)) == RET_OK) {
 
-		pcStat = get_stat(pstStatus, &(pstNeighbor->stPoint));
+		// ͕Wo͂̂܂܃NCAg֌ď
+		fflush(stdout);
+		dup2(stClient.iFd, STDOUT_FILENO);
+		gpstClient = &stClient;
 
-		if (strcmp(pcStat + 2, CLOSE_MARK) == 0) {
-			continue;
+		if (read_client_line(&stClient, pcLine) == RET_OK) {
+			chop(pcLine);
+			handle_command(&stClient, pcLine);
 		}
 
-		if (atoi(pcStat) > 0) {
-			ppcExitPoints[pstNeighbor->stPoint.cRow][pstNeighbor->stPoint.cCol] = FLG_ON;
-		}
+		fflush(stdout);
+		gpstClient = NULL;
+		dup2(iStdoutFd, STDOUT_FILENO);
+		close(stClient.iFd);
 
-		if (has_stat(pstStatus, &(pstNeighbor->stPoint)) == RET_OK) {
-			continue;
+		if (send_handoff(iCtrlFd, &stClient, -1) != RET_OK) {
+			break;
 		}
-
-		fill_partition_forward1(pstStatus, &(pstNeighbor->stPoint), ppcExitPoints);
 	}
+
+	close(iStdoutFd);
+	close(iCtrlFd);
 }
 
-static void open_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	char *pcLinkName,
-	char *pcMark
+static void accept_connection(
+	int iListenFd
 ) {
 
-	set_stat(pstStatus, pstPoint, pcLinkName, pcMark);
-	update_fd1_point(pstStatus, pstPoint);
+	pCONNECTION pstConn;
+	int iFd;
+	int i;
+
+	iFd = accept(iListenFd, NULL, NULL);
+	if (iFd < 0) {
+		return;
+	}
+
+	for (i = 0; gpstConnections[i].cState != CONN_FREE; i++) {
+	}
 
+	pstConn = &(gpstConnections[i]);
+	pstConn->stClient.iFd = iFd;
+	pstConn->stClient.iLen = 0;
+	pstConn->stClient.cClosed = FLG_OFF;
+	pstConn->cState = CONN_IDLE;
+	gpstServerStats->iClients++;
 }
 
-static void set_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	char *pcLinkName,
-	char *pcMark
+static void read_connection(
+	int iConn
 ) {
 
-	char *pcDest = pstStatus->pppcStats[pstPoint->cRow][pstPoint->cCol];
-	if (pcMark == NULL) {
-		sprintf(pcDest, "%2s", pcLinkName);
+	pCLIENT pstClient;
+	int iLen;
+
+	pstClient = &(gpstConnections[iConn].stClient);
+
+	iLen = recv(pstClient->iFd, pstClient->pcBuf + pstClient->iLen, LINE_BUF_LEN - pstClient->iLen, 0);
+	if (iLen > 0) {
+		pstClient->iLen += iLen;
 	} else {
-		sprintf(pcDest, "%2s%1s", pcLinkName, pcMark);
+		pstClient->cClosed = FLG_ON;
 	}
-}
 
-static void close_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
-) {
-	char *pcDest = pstStatus->pppcStats[pstPoint->cRow][pstPoint->cCol];
-	strcpy(pcDest + 2, CLOSE_MARK);
+	process_connection(iConn);
 }
 
-static void fill_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static void process_connection(
+	int iConn
 ) {
-	char *pcDest = pstStatus->pppcStats[pstPoint->cRow][pstPoint->cCol];
-	strcpy(pcDest, FILLER);
-}
 
-static char* get_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
-) {
-	return pstStatus->pppcStats[pstPoint->cRow][pstPoint->cCol];
-}
+	pCONNECTION pstConn;
+	CLIENT stNext;
+	char pcLine[LINE_BUF_LEN + 1];
+	int iStdoutFd;
+	char cRet;
 
-static char has_stat(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
-) {
+	pstConn = &(gpstConnections[iConn]);
 
-	if (*get_stat(pstStatus, pstPoint) == '\0') {
-		return RET_NG;
-	}
+	// Mς݂̍sɏA'solve' ̓[J[̋󂫂҂ɕׂ
+	while (
+		memchr(pstConn->stClient.pcBuf, '\n', pstConn->stClient.iLen) != NULL
+		|| pstConn->stClient.iLen >= LINE_BUF_LEN
+		|| (pstConn->stClient.cClosed == FLG_ON && pstConn->stClient.iLen > 0)
+	) {
 
-	return RET_OK;
-}
+		// 'solve' ̍s̓[J[ǂݒ̂ŁAǂݎȌԂcĂ
+		stNext = pstConn->stClient;
+		read_client_line(&stNext, pcLine);
+		chop(pcLine);
 
-static void set_direction(
-	pSTATUS pstStatus,
-	pPOINT pstPoint,
-	pDIRECTION pstDir
-) {
-	char cRow = pstPoint->cRow;
-	char cCol = pstPoint->cCol;
-	char cDir =  pstDir - gpstDirections;
-	char *pcDest;
+		if (is_solve_line(pcLine)) {
+			pstConn->cState = CONN_QUEUED;
+			pstConn->iQueueNo = ++giQueueNo;
+			gpstServerStats->iQueued++;
+			return;
+		}
+		pstConn->stClient = stNext;
 
-	switch (cDir) {
-	case DIR_UP:
-		pcDest = pstStatus->pppcHwalls[cRow][cCol];
-		break;
-	case DIR_DOWN:
-		pcDest = pstStatus->pppcHwalls[cRow + 1][cCol];
-		break;
-	case DIR_LEFT:
-		pcDest = pstStatus->pppcVwalls[cRow][cCol];
-		break;
-	case DIR_RIGHT:
-		pcDest = pstStatus->pppcVwalls[cRow][cCol + 1];
-		break;
-	default:
-		return;
-		break;
+		fflush(stdout);
+		iStdoutFd = dup(STDOUT_FILENO);
+		dup2(pstConn->stClient.iFd, STDOUT_FILENO);
+
+		cRet = handle_command(&(pstConn->stClient), pcLine);
+
+		fflush(stdout);
+		dup2(iStdoutFd, STDOUT_FILENO);
+		close(iStdoutFd);
+
+		if (cRet != RET_OK) {
+			close_connection(iConn);
+			return;
+		}
 	}
 
-	strcpy(pcDest, pstDir->pcDirMark);
+	if (pstConn->stClient.cClosed == FLG_ON) {
+		close_connection(iConn);
+	}
 }
 
-static void get_neighbors(
-	pPOINT pstPoint,
-	pNEIGHBOR pstNeighbors
-) {
-
-	pDIRECTION pstDirection;
-	char c;
-	char cRow;
-	char cCol;
+static void dispatch_requests(void) {
 
-	memset(pstNeighbors, '\0', sizeof(NEIGHBOR) * (NEIGHBOR_CNT + 1));
+	pCONNECTION pstConn;
+	pWORKER pstWorker;
+	int iConn;
+	int i;
+	int j;
 
-	for (pstDirection = gpstDirections, c = 0; c < NEIGHBOR_CNT; pstDirection++, c++) {
+	for (i = 0; i < giWorkers; i++) {
 
-		cRow= pstPoint->cRow + pstDirection->cRowDelta;
-		if (cRow < 0 || cRow >= gcSize) {
+		pstWorker = &(gpstWorkers[i]);
+		if (pstWorker->iFd < 0 || pstWorker->iConn >= 0) {
 			continue;
 		}
 
-		cCol = pstPoint->cCol + pstDirection->cColDelta;
-		if (cCol < 0 || cCol >= gcSize) {
+		// ɕ񂾗vn
+		iConn = -1;
+		for (j = 0; j < MAX_CLIENTS; j++) {
+			if (
+				gpstConnections[j].cState == CONN_QUEUED
+				&& (iConn < 0 || gpstConnections[j].iQueueNo < gpstConnections[iConn].iQueueNo)
+			) {
+				iConn = j;
+			}
+		}
+		if (iConn < 0) {
+			return;
+		}
+
+		pstConn = &(gpstConnections[iConn]);
+		gpstServerStats->iQueued--;
+		if (send_handoff(pstWorker->iFd, &(pstConn->stClient), pstConn->stClient.iFd) != RET_OK) {
+			close_connection(iConn);
 			continue;
 		}
 
-		pstNeighbors->pstDir = pstDirection;
-		pstNeighbors->stPoint.cRow = cRow;
-		pstNeighbors->stPoint.cCol = cCol;
-		pstNeighbors++;
+		pstConn->cState = CONN_SOLVING;
+		pstConn->stClient.iLen = 0;
+		pstWorker->iConn = iConn;
+		gpstServerStats->iBusy++;
 	}
-
 }
 
-static void close_connected_link(
-	pSTATUS pstStatus,
-	pLINK_PART pstLinkPart
+static void finish_request(
+	int iWorker,
+	int iListenFd
 ) {
 
-	POINT stFrom = pstLinkPart->stStart;
-	POINT stTo = pstLinkPart->stEnd;
-	pDIRECTION pstDirection;
-	char c;
-	char cPrev;
-	char cNext;
-
-	for (pstDirection = gpstDirections, c = 0; c < NEIGHBOR_CNT; pstDirection++, c++) {
-		if (
-			(stTo.cRow - stFrom.cRow == pstDirection->cRowDelta)
-			&& (stTo.cCol - stFrom.cCol == pstDirection->cColDelta)
-		) {
-			break;
+	pWORKER pstWorker;
+	pCONNECTION pstConn;
+	CLIENT stClient;
+	int iConn;
+	char cRet;
+
+	pstWorker = &(gpstWorkers[iWorker]);
+	iConn = pstWorker->iConn;
+
+	cRet = recv_handoff(pstWorker->iFd, &stClient, NULL);
+
+	if (iConn >= 0) {
+		pstWorker->iConn = -1;
+		gpstServerStats->iBusy--;
+		pstConn = &(gpstConnections[iConn]);
+		if (cRet != RET_OK) {
+			close_connection(iConn);
+		} else {
+			// [J[ǂݎc瑱
+			stClient.iFd = pstConn->stClient.iFd;
+			pstConn->stClient = stClient;
+			pstConn->cState = CONN_IDLE;
+			process_connection(iConn);
 		}
 	}
 
-	if (c >= NEIGHBOR_CNT) {
-		return;
+	// [J[͕[
+	if (cRet != RET_OK) {
+		close(pstWorker->iFd);
+		waitpid(pstWorker->iPid, NULL, 0);
+		start_worker(iWorker, iListenFd);
 	}
+}
 
-	cPrev = pstLinkPart->cPrev;
-	if (cPrev < 0) {
-		close_stat(pstStatus, &stFrom);
-	} else if (pstStatus->pstLinkParts[cPrev].cClose == FLG_ON) {
-		close_stat(pstStatus, &stFrom);
+static void close_connection(
+	int iConn
+) {
+
+	pCONNECTION pstConn;
+
+	pstConn = &(gpstConnections[iConn]);
+	if (pstConn->cState == CONN_QUEUED) {
+		gpstServerStats->iQueued--;
 	}
-	set_direction(pstStatus, &stFrom, pstDirection);
-	cNext = pstLinkPart->cNext;
-	if (cNext < 0) {
-		close_stat(pstStatus, &stTo);
-	} else if (pstStatus->pstLinkParts[cNext].cClose == FLG_ON) {
-		close_stat(pstStatus, &stTo);
+
+	close(pstConn->stClient.iFd);
+	pstConn->cState = CONN_FREE;
+	gpstServerStats->iClients--;
+}
+
+static char send_handoff(
+	int iCtrlFd,
+	pCLIENT pstClient,
+	int iFd
+) {
+
+	HANDOFF stHandoff;
+	struct msghdr stMsg;
+	struct iovec stIov;
+	union {
+		struct cmsghdr stHeader;
+		char pcBuf[CMSG_SPACE(sizeof(int))];
+	} uControl;
+	struct cmsghdr *pstHeader;
+
+	memset(&stHandoff, '\0', sizeof(stHandoff));
+	stHandoff.cClosed = pstClient->cClosed;
+	stHandoff.iLen = pstClient->iLen;
+	memcpy(stHandoff.pcBuf, pstClient->pcBuf, pstClient->iLen);
+
+	memset(&stMsg, '\0', sizeof(stMsg));
+	stIov.iov_base = &stHandoff;
+	stIov.iov_len = sizeof(stHandoff);
+	stMsg.msg_iov = &stIov;
+	stMsg.msg_iovlen = 1;
+
+	// ڑ̂̂͋LqqƂēYēn
+	if (iFd >= 0) {
+		memset(&uControl, '\0', sizeof(uControl));
+		stMsg.msg_control = uControl.pcBuf;
+		stMsg.msg_controllen = sizeof(uControl.pcBuf);
+		pstHeader = CMSG_FIRSTHDR(&stMsg);
+		pstHeader->cmsg_level = SOL_SOCKET;
+		pstHeader->cmsg_type = SCM_RIGHTS;
+		pstHeader->cmsg_len = CMSG_LEN(sizeof(int));
+		memcpy(CMSG_DATA(pstHeader), &iFd, sizeof(int));
 	}
-	pstLinkPart->cClose = FLG_ON;
 
-	DEBUG_PRINTF("\n ----- link ");
-	DEBUG_PRINT_LINK(pstLinkPart);
-	DEBUG_PRINTF(" closed. -----\n");
-	DEBUG_PRINT_GRID(pstStatus);
+	if (sendmsg(iCtrlFd, &stMsg, 0) != (ssize_t) sizeof(stHandoff)) {
+		return RET_NG;
+	}
 
+	return RET_OK;
 }
 
-static pLINK_PART get_open_link(
-	pSTATUS pstStatus
+static char recv_handoff(
+	int iCtrlFd,
+	pCLIENT pstClient,
+	int *piFd
 ) {
-	pLINK_PART pstLinkPart;
 
-	for (pstLinkPart = pstStatus->pstLinkParts; HAS_LINK(pstLinkPart); pstLinkPart++) {
-		if (pstLinkPart->cClose == FLG_OFF) {
-			return pstLinkPart;
+	HANDOFF stHandoff;
+	struct msghdr stMsg;
+	struct iovec stIov;
+	union {
+		struct cmsghdr stHeader;
+		char pcBuf[CMSG_SPACE(sizeof(int))];
+	} uControl;
+	struct cmsghdr *pstHeader;
+
+	memset(&stMsg, '\0', sizeof(stMsg));
+	stIov.iov_base = &stHandoff;
+	stIov.iov_len = sizeof(stHandoff);
+	stMsg.msg_iov = &stIov;
+	stMsg.msg_iovlen = 1;
+	stMsg.msg_control = uControl.pcBuf;
+	stMsg.msg_controllen = sizeof(uControl.pcBuf);
+
+	// 肪IĂ 0 oCgŕԂ
+	if (recvmsg(iCtrlFd, &stMsg, 0) != (ssize_t) sizeof(stHandoff)) {
+		return RET_NG;
+	}
+	if (stHandoff.iLen < 0 || stHandoff.iLen > LINE_BUF_LEN) {
+		return RET_NG;
+	}
+
+	if (piFd != NULL) {
+		pstHeader = CMSG_FIRSTHDR(&stMsg);
+		if (
+			pstHeader == NULL
+			|| pstHeader->cmsg_level != SOL_SOCKET
+			|| pstHeader->cmsg_type != SCM_RIGHTS
+		) {
+			return RET_NG;
 		}
+		memcpy(piFd, CMSG_DATA(pstHeader), sizeof(int));
 	}
 
-	return NULL;
+	pstClient->cClosed = stHandoff.cClosed;
+	pstClient->iLen = stHandoff.iLen;
+	memcpy(pstClient->pcBuf, stHandoff.pcBuf, stHandoff.iLen);
+
+	return RET_OK;
 }
 
-static void set_fd1_point(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static char is_solve_line(
+	const char *pcLine
 ) {
-	pstStatus->ppcFd1Flags[pstPoint->cRow][pstPoint->cCol] = FLG_ON;
+	return strncmp(pcLine, "solve", 5) == 0 && (pcLine[5] == '\0' || isspace(pcLine[5]));
 }
 
-static void delete_fd1_point(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static char handle_command(
+	pCLIENT pstClient,
+	char *pcLine
 ) {
-	pstStatus->ppcFd1Flags[pstPoint->cRow][pstPoint->cCol] = FLG_OFF;
+
+	if (*pcLine == '\0') {
+		return RET_OK;
+	}
+
+	if (strcmp(pcLine, "quit") == 0) {
+		return RET_NG;
+	}
+
+	// Iɓ͖͂
+	if (strcmp(pcLine, "cancel") == 0) {
+		return RET_OK;
+	}
+
+	if (strcmp(pcLine, "stats") == 0) {
+		print_server_stats();
+	} else if (is_solve_line(pcLine)) {
+		handle_solve(pstClient, pcLine + 5);
+	} else {
+		printf("%s : 'solve', 'stats' or 'quit' required.\n", pcLine);
+	}
+
+	printf("end\n");
+	fflush(stdout);
+
+	return RET_OK;
 }
 
-static void update_fd1_point(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static void handle_solve(
+	pCLIENT pstClient,
+	char *pcArgs
 ) {
 
-	POINT pstArounds[AROUND_CNT + 1];
-	pPOINT pstAround;
+	char pcLine[LINE_BUF_LEN + 1];
+	int iLineCnt;
+	char cParsed;
+	char cEnd;
+	char cBinary;
+	char *pcArg;
+	double dValue;
+
+	long iMaxNodes;
+	double dTimeLimit;
+	long iMaxMemory;
+
+	// T[oŜ̎wlƂAvƂɏ㏑
+	iMaxNodes = giMaxNodes;
+	dTimeLimit = gdTimeLimit;
+	iMaxMemory = giMaxMemory;
+
+	// wɌ肪ΉɃG[Ԃ
+	cParsed = RET_OK;
+	cBinary = FLG_OFF;
+	for (pcArg = strtok(pcArgs, " \t"); pcArg != NULL; pcArg = strtok(NULL, " \t")) {
+		if (strcmp(pcArg, "binary") == 0) {
+			cBinary = FLG_ON;
+		} else if (strncmp(pcArg, "max-nodes=", 10) == 0 && parse_solve_value(pcArg + 10, &dValue) == RET_OK) {
+			giMaxNodes = (long) dValue;
+		} else if (strncmp(pcArg, "time-limit=", 11) == 0 && parse_solve_value(pcArg + 11, &dValue) == RET_OK) {
+			gdTimeLimit = dValue;
+		} else if (strncmp(pcArg, "max-memory=", 11) == 0 && parse_solve_value(pcArg + 11, &dValue) == RET_OK) {
+			giMaxMemory = (long) dValue;
+		} else if (
+			strncmp(pcArg, "max-nodes=", 10) == 0
+			|| strncmp(pcArg, "time-limit=", 11) == 0
+			|| strncmp(pcArg, "max-memory=", 11) == 0
+		) {
+			printf("%s : a number of 0 or more required.\n", pcArg);
+			cParsed = RET_NG;
+		} else {
+			printf("%s : unknown solve option.\n", pcArg);
+			cParsed = RET_NG;
+		}
+	}
 
-	delete_fd1_point(pstStatus, pstPoint);
+	clear_def();
+	iLineCnt = 0;
+	cEnd = FLG_OFF;
 
-	get_arounds(pstPoint, pstArounds);
-	for (pstAround = pstArounds; HAS_POINT(pstAround); pstAround++) {
+	// oCi̗v͌o 1 ̋L^̂Ƃ 'end' ̍s
+	if (cParsed == RET_OK && cBinary == FLG_ON) {
+		cParsed = read_client_bin(pstClient);
+	}
 
-		if (has_stat(pstStatus, pstAround) == RET_OK) {
-			continue;
+	// G[Ă 'end' ܂ł͓ǂݎ̂Ă
+	while (read_client_line(pstClient, pcLine) == RET_OK) {
+		++iLineCnt;
+		chop(pcLine);
+		if (strcmp(pcLine, "end") == 0) {
+			cEnd = FLG_ON;
+			break;
 		}
-
-		if (has_split_at(pstStatus, pstAround) != RET_OK) {
-			delete_fd1_point(pstStatus, pstAround);
+		if (cParsed != RET_OK) {
 			continue;
 		}
+		if (cBinary == FLG_OFF) {
+			cParsed = parse_line(pcLine, pcLine + strlen(pcLine), REQUEST_NAME, iLineCnt);
+		} else if (*pcLine != '\0') {
+			printf("%s(%d) : 'end' required after the binary record.\n", REQUEST_NAME, iLineCnt);
+			cParsed = RET_NG;
+		}
+	}
+
+	__sync_fetch_and_add(&(gpstServerStats->iRequests), 1);
+
+	if (cEnd != FLG_ON) {
+		__sync_fetch_and_add(&(gpstServerStats->iCanceled), 1);
+	} else if (cParsed != RET_OK) {
+		printf("\n");
+		__sync_fetch_and_add(&(gpstServerStats->iErrors), 1);
+	} else if (gcSize < 0) {
+		printf("%s(%d) : size required.\n", REQUEST_NAME, iLineCnt);
+		__sync_fetch_and_add(&(gpstServerStats->iErrors), 1);
+	} else {
+
+		init_globals();
 
-		set_fd1_point(pstStatus, pstAround);
+		cParsed = solve();
+		__sync_fetch_and_add(&(gpstServerStats->iNodes), giNodeCases);
+
+		if (cParsed != RET_OK) {
+			printf("\n");
+			__sync_fetch_and_add(&(gpstServerStats->iErrors), 1);
+		} else if (gcStopReason == STOP_SOLVED) {
+			__sync_fetch_and_add(&(gpstServerStats->iSolved), 1);
+		} else if (gcStopReason == STOP_NONE) {
+			__sync_fetch_and_add(&(gpstServerStats->iUnsat), 1);
+		} else if (gcStopReason == STOP_CANCEL) {
+			__sync_fetch_and_add(&(gpstServerStats->iCanceled), 1);
+		} else {
+			__sync_fetch_and_add(&(gpstServerStats->iBudget), 1);
+		}
 	}
 
+	giMaxNodes = iMaxNodes;
+	gdTimeLimit = dTimeLimit;
+	giMaxMemory = iMaxMemory;
 }
 
-static char is_fd1_point(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static char parse_solve_value(
+	const char *pcValue,
+	double *pdValue
 ) {
-	if (pstStatus->ppcFd1Flags[pstPoint->cRow][pstPoint->cCol] == FLG_ON) {
-		return RET_OK;
-	} else {
+
+	char *pcEnd;
+
+	// ̒l␔̂Ƃ̗]vȕ 0 Ƃ݂ȂɃG[ɂ
+	if (*pcValue == '\0' || isspace(*pcValue)) {
+		return RET_NG;
+	}
+
+	errno = 0;
+	*pdValue = strtod(pcValue, &pcEnd);
+	if (*pcEnd != '\0' || errno != 0 || !(*pdValue >= 0) || *pdValue > LONG_MAX) {
 		return RET_NG;
 	}
+
+	return RET_OK;
 }
 
-static void get_arounds(
-	pPOINT pstPoint,
-	pPOINT pstArounds
+static char read_client_line(
+	pCLIENT pstClient,
+	char *pcLine
 ) {
-	pDIRECTION pstDirection;
-	char c;
-	char cRow;
-	char cCol;
 
-	memset(pstArounds, '\0', sizeof(POINT) * (AROUND_CNT + 1));
+	char *pcNewLine;
+	int iLen;
 
-	for (pstDirection = gpstArounds, c = 0; c < AROUND_CNT; pstDirection++, c++) {
+	for (;;) {
 
-		cRow= pstPoint->cRow + pstDirection->cRowDelta;
-		if (cRow < 0 || cRow >= gcSize) {
-			continue;
+		pcNewLine = memchr(pstClient->pcBuf, '\n', pstClient->iLen);
+		if (pcNewLine != NULL) {
+			iLen = pcNewLine - pstClient->pcBuf + 1;
+		} else if (pstClient->iLen >= LINE_BUF_LEN) {
+			iLen = pstClient->iLen;
+		} else {
+			iLen = recv(pstClient->iFd, pstClient->pcBuf + pstClient->iLen, LINE_BUF_LEN - pstClient->iLen, 0);
+			if (iLen > 0) {
+				pstClient->iLen += iLen;
+				continue;
+			}
+			pstClient->cClosed = FLG_ON;
+			if (pstClient->iLen == 0) {
+				return RET_NG;
+			}
+			// ŝȂŏIs
+			iLen = pstClient->iLen;
 		}
 
-		cCol = pstPoint->cCol + pstDirection->cColDelta;
-		if (cCol < 0 || cCol >= gcSize) {
-			continue;
-		}
+		memcpy(pcLine, pstClient->pcBuf, iLen);
+		pcLine[iLen] = '\0';
+		pstClient->iLen -= iLen;
+		memmove(pstClient->pcBuf, pstClient->pcBuf + iLen, pstClient->iLen);
 
-		pstArounds->cRow = cRow;
-		pstArounds->cCol = cCol;
-		pstArounds++;
+		return RET_OK;
 	}
-
-	pstArounds->cRow = -1;
-
 }
 
-static char has_split_at(
-	pSTATUS pstStatus,
-	pPOINT pstPoint
+static char read_client_bytes(
+	pCLIENT pstClient,
+	unsigned char *pbDest,
+	long iLen
 ) {
 
-	pDIRECTION pstDirection;
-	char c;
-	char cRow;
-	char cCol;
-	POINT stAround;
-	int iAroundPat;
-	int iAroundFlg;
-
-	iAroundPat = 0;
-	for (pstDirection = gpstArounds, c = 0; c < AROUND_CNT; pstDirection++, c++) {
+	int iRecvLen;
+	int iCopyLen;
 
-		iAroundFlg = 1 << c;
+	// sǂ񂾎c̎Mς݂̕Ɏg
+	while (iLen > 0) {
 
-		cRow = pstPoint->cRow + pstDirection->cRowDelta;
-		if (cRow < 0 || cRow >= gcSize) {
-			iAroundPat |= iAroundFlg;
-			continue;
+		if (pstClient->iLen == 0) {
+			iRecvLen = recv(pstClient->iFd, pstClient->pcBuf, LINE_BUF_LEN, 0);
+			if (iRecvLen <= 0) {
+				pstClient->cClosed = FLG_ON;
+				return RET_NG;
+			}
+			pstClient->iLen = iRecvLen;
 		}
 
-		cCol = pstPoint->cCol + pstDirection->cColDelta;
-		if (cCol < 0 || cCol >= gcSize) {
-			iAroundPat |= iAroundFlg;
-			continue;
-		}
+		iCopyLen = (pstClient->iLen < iLen) ? pstClient->iLen : iLen;
+		memcpy(pbDest, pstClient->pcBuf, iCopyLen);
+		pstClient->iLen -= iCopyLen;
+		memmove(pstClient->pcBuf, pstClient->pcBuf + iCopyLen, pstClient->iLen);
+		pbDest += iCopyLen;
+		iLen -= iCopyLen;
+	}
 
-		stAround.cRow = cRow;
-		stAround.cCol = cCol;
-		if (has_stat(pstStatus, &stAround) == RET_OK) {
-			iAroundPat |= iAroundFlg;
-		}
+	return RET_OK;
+}
+
+static char read_client_bin(
+	pCLIENT pstClient
+) {
+
+	unsigned char pbBuf[BIN_HEADER_LEN + 2 + BIN_RECORD_LEN];
+	BIN_FILE stBin;
+	const unsigned char *pbRec;
+	long iLen;
+	char cResult;
+
+	// oCĩf[^t@CƓôƂɁAt̋L^ 1 
+	if (read_client_bytes(pstClient, pbBuf, BIN_HEADER_LEN + 2) != RET_OK) {
+		return RET_NG;
 	}
 
-	if (gpcSplitPatternTbl[iAroundPat] == FLG_ON) {
-		return RET_OK;
-	} else {
+	if (!is_bin_def((const char *) pbBuf, BIN_HEADER_LEN)) {
+		printf("%s : binary header required.\n", REQUEST_NAME);
+		return RET_NG;
+	}
+	if (pbBuf[4] != BIN_VERSION) {
+		printf("%s : binary version %d is not supported.\n", REQUEST_NAME, pbBuf[4]);
+		return RET_NG;
+	}
+
+	iLen = get_le(pbBuf + BIN_HEADER_LEN, 2);
+	if (iLen == 0 || iLen > BIN_RECORD_LEN) {
+		printf("%s(#0) : broken record.\n", REQUEST_NAME);
+		return RET_NG;
+	}
+
+	if (read_client_bytes(pstClient, pbBuf + BIN_HEADER_LEN + 2, iLen) != RET_OK) {
 		return RET_NG;
 	}
+
+	stBin.pcFileName = REQUEST_NAME;
+	stBin.pbBuf = pbBuf;
+	stBin.iLen = BIN_HEADER_LEN + 2 + iLen;
+	stBin.pbIndex = pbBuf + stBin.iLen;
+	stBin.iCount = 1;
+	pbRec = pbBuf + BIN_HEADER_LEN;
+
+	return read_bin(&stBin, &pbRec, 0, &cResult, NULL);
 }
 
-static void print_grid(
-	pSTATUS pstStatus
+static char check_client(
+	pCLIENT pstClient
 ) {
 
-	POINT stPoint;
+	struct pollfd stPoll;
+	char pcLine[LINE_BUF_LEN + 1];
+	int iLen;
 
-	for (stPoint.cRow = 0; stPoint.cRow < gcSize; stPoint.cRow++) {
-		if (stPoint.cRow > 0) {
-			for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
-				if (stPoint.cCol > 0) {
-					printf("+");
-				}
-				printf("%3s", pstStatus->pppcHwalls[stPoint.cRow][stPoint.cCol]);
-			}
-			printf("\n");
+	if (pstClient->iLen == 0) {
+
+		stPoll.fd = pstClient->iFd;
+		stPoll.events = POLLIN;
+		if (poll(&stPoll, 1, 0) <= 0) {
+			return RET_OK;
 		}
-		for (stPoint.cCol = 0; stPoint.cCol < gcSize; stPoint.cCol++) {
-			if (stPoint.cCol > 0) {
-				printf("%1s", pstStatus->pppcVwalls[stPoint.cRow][stPoint.cCol]);
-			}
-			if (has_stat(pstStatus, &stPoint) == RET_OK) {
-				printf("%-3s", get_stat(pstStatus, &stPoint));
-			} else if (is_fd1_point(pstStatus, &stPoint) == RET_OK) {
-				printf(FD1_MARK);
-			} else {
-				printf("   ");
-			}
+
+		// ؒfꂽ
+		iLen = recv(pstClient->iFd, pstClient->pcBuf, LINE_BUF_LEN, 0);
+		if (iLen <= 0) {
+			pstClient->cClosed = FLG_ON;
+			return RET_NG;
 		}
-		printf("\n");
+		pstClient->iLen = iLen;
 	}
+
+	// 㑱̗v͎cĂA'cancel' ǂݎ
+	if (pstClient->iLen >= 6 && memcmp(pstClient->pcBuf, "cancel", 6) == 0) {
+		read_client_line(pstClient, pcLine);
+		return RET_NG;
+	}
+
+	return RET_OK;
 }
 
-static void print_status(
-	pSTATUS pstStatus
-) {
+static void print_server_stats(void) {
 
 	time_t tNowTime;
-	int iElapsed;
-	int iElapsed2;
-	int iHours;
-	int iMinutes;
-	int iSeconds;
 
 	time(&tNowTime);
-	iElapsed = (int) difftime(tNowTime, gtStartTime);
-
-	iElapsed2 = iElapsed / 60;
-	iHours = iElapsed2 / 60;
-	iMinutes = iElapsed2 % 60;
-	iSeconds = iElapsed % 60;
 
 	printf(
-    	"\ntm:%02d:%02d:%02d, br:%d, de:%d, dp:%d, sl:%d, fdp:%d, msl:%d, ok:%d\n",
-    	iHours,
-    	iMinutes,
-    	iSeconds,
-        giBranchErrCases,
-        giDeadEndCases,
-        giDeadPartitionCases,
-        giSplitLinkCases,
-        giFd1DeadPartitionCases,
-        giMultiSplitCases,
-        giOkCases
-    );
-
-    print_grid(pstStatus);
-
+		"requests:%ld, solved:%ld, unsat:%ld, budget:%ld, canceled:%ld, errors:%ld, nodes:%ld, busy:%ld, queued:%ld, clients:%ld, workers:%d, uptime:%d\n",
+		gpstServerStats->iRequests,
+		gpstServerStats->iSolved,
+		gpstServerStats->iUnsat,
+		gpstServerStats->iBudget,
+		gpstServerStats->iCanceled,
+		gpstServerStats->iErrors,
+		gpstServerStats->iNodes,
+		gpstServerStats->iBusy,
+		gpstServerStats->iQueued,
+		gpstServerStats->iClients,
+		giWorkers,
+		(int) difftime(tNowTime, gpstServerStats->tStartTime)
+	);
 }
 
 static void print_progress(
 	pSTATUS pstStatus
 ) {
+	// ĊJ̍Č̃m[h͐ς
+	if (giDepth < giResumeDepth) {
+		return;
+	}
+
 	if (BREAK > 0) {
-		printf(".");
 		giOkCases++;
+		if (gcQuiet == FLG_ON) {
+			return;
+		}
+		putchar('.');
+
+		// ͗Ao߂Ƃɂ܂Ƃ߂ė
 		if (giOkCases % BREAK == 0) {
 			print_status(pstStatus);
+			fflush(stdout);
 		}
-		fflush(stdout);
 	}
 }
 
@@ -1497,7 +9712,7 @@ static void print_exit(
 
 	for (cRow = 0; cRow < gcSize; cRow++) {
 		for (cCol = 0; cCol < gcSize; cCol++) {
-			if (ppcExitPoints[cRow][cCol] != FLG_ON) {
+			if (ppcExitPoints[(int) cRow][(int) cCol] != FLG_ON) {
 				continue;
 			}
 			printf("[%d, %d], ", cRow, cCol);
@@ -1,5 +1,6 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #define BLOCK_SIZE					8
 #define LINE_SIZE					(BLOCK_SIZE * 4)
@@ -0,0 +1,16 @@
+size 7
+link '1', [0,0], [6,2]
+link '2', [5,1], [6,6]
+link '3', [0,5], [4,5]
+link '4', [3,2], [0,6]
+link '5', [1,3], [4,3]
+link '6', [0,1], [2,2]
+size 5
+link '1', [1,3], [1,4]
+link '2', [4,1], [4,2]
+link '3', [1,0], [1,2]
+size 5
+link '1', [0,2], [0,4]
+link '2', [3,1], [0,3]
+link '3', [0,0], [0,1]
+link '4', [4,4], [4,3]
@@ -0,0 +1,16 @@
+size 10
+link '1', [7,6], [2,8]
+link '2', [3,8], [9,7]
+link '3', [9,8], [0,8]
+link '4', [1,8], [0,6]
+link '5', [1,6], [9,6]
+link '6', [9,5], [6,3]
+link '7', [7,3], [8,4]
+link '8', [7,4], [4,5]
+link '9', [4,4], [2,5]
+link '10', [2,4], [0,5]
+link '11', [0,4], [1,1]
+link '12', [1,2], [5,2]
+link '13', [4,2], [2,2]
+link '14', [2,1], [9,0]
+link '15', [8,0], [0,0]
@@ -0,0 +1,5 @@
+size 9
+link '1', [3,3], [8,0]
+link '2', [1,3], [4,7]
+link '3', [3,4], [0,6]
+link '4', [2,1], [7,3]
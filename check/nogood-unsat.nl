@@ -0,0 +1,6 @@
+size 8
+link '1', [5,1], [4,4]
+link '2', [6,4], [2,5]
+link '3', [6,5], [7,6]
+link '4', [0,7], [2,6]
+link '5', [2,1], [1,3]
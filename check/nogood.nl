@@ -0,0 +1,8 @@
+size 11
+link '1', [0,0], [10,1]
+link '2', [10,0], [9,8]
+link '3', [9,1], [4,6]
+link '4', [8,4], [7,2]
+link '5', [8,2], [9,2]
+link '6', [7,5], [6,6]
+link '7', [3,4], [5,2]
@@ -0,0 +1,7 @@
+size 7
+link '6', [0,6], [2,0]
+link '5', [1,1], [6,0]
+link '4', [5,6], [5,2]
+link '3', [2,3], [6,6]
+link '2', [3,5], [3,2]
+link '1', [1,6], [2,4]
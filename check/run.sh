@@ -0,0 +1,172 @@
+#!/bin/sh
+# usage: sh check/run.sh [solver]
+#
+# solves the puzzles of this directory and checks the exit status and
+# the result line (result and node count) of each run.
+# the server checks need python3 for the socket client.
+
+SOLVER=${1:-$(dirname "$0")/../NumLinkSolver}
+SOLVER="$(cd "$(dirname "$SOLVER")" && pwd)/$(basename "$SOLVER")"
+cd "$(dirname "$0")"
+
+WORK=$(mktemp -d)
+trap 'rm -rf "$WORK"' EXIT
+
+PASS=0
+FAIL=0
+
+# check name status text command...
+#   runs the command and checks its exit status and that its output holds text
+check() {
+	name=$1
+	status=$2
+	text=$3
+	shift 3
+	"$@" > "$WORK/out" 2>&1
+	got=$?
+	if [ "$got" = "$status" ] && grep -qF -e "$text" "$WORK/out"; then
+		PASS=$((PASS + 1))
+	else
+		FAIL=$((FAIL + 1))
+		echo "NG $name : exit $got (expected $status), expected \"$text\""
+		sed 's/^/    /' "$WORK/out" | tail -5
+	fi
+}
+
+# solving
+check sample 0 "result:solved, nodes:59," "$SOLVER" ../sample.nl
+check small 0 "result:solved, nodes:23," "$SOLVER" small.nl
+check groups 0 "result:solved, nodes:105," "$SOLVER" groups.nl
+check groups-jobs 0 "result:solved, nodes:105," "$SOLVER" --jobs 2 groups.nl
+check unsat 1 "result:unsat, nodes:1," "$SOLVER" unsat.nl
+check hard 1 "result:unsat, nodes:8456," "$SOLVER" hard.nl
+check hard-partner 1 "result:unsat, nodes:8456," "$SOLVER" --order partner hard.nl
+check hard-distribute 1 "result:unsat, nodes:8456," "$SOLVER" --distribute 2 hard.nl
+check path 0 "result:solved, nodes:44," "$SOLVER" path.nl
+check path-cells 0 "path:3 cells" "$SOLVER" path.nl
+check path-end 0 "drrrdd*/ddllddu/dd*lldu/ddrrddu/drr*d*u/drrdrru/rr*rrr*" "$SOLVER" --format dirs pathend.nl
+check path-end-nodes 0 "result:solved, nodes:47," "$SOLVER" pathend.nl
+check path-waypoint 0 "drrrdd*/ddllddu/dd*lldu/ddrrddu/drr*d*u/drrdrru/rr*rrr*" "$SOLVER" --format dirs waypoint.nl
+{ grep -v "^path" waypoint.nl; echo "path '1', [3,0], [4,0]"; } > "$WORK/waypoint.nl"
+check path-open-waypoint 4 "path '1' must start at an open end of the link or a waypoint it has reached, not [3,0]." \
+	"$SOLVER" "$WORK/waypoint.nl"
+check json 0 '"result":"solved","nodes":59,' "$SOLVER" --format json ../sample.nl
+check dirs 0 "drrrdd*/ddllddu/dd*lldu/ddrrddu/drr*d*u/drrdrru/rr*rrr*" "$SOLVER" --format dirs ../sample.nl
+
+# groups known to have no solution give the same board with fewer nodes
+check nogood 0 "result:solved, nodes:684," "$SOLVER" nogood.nl
+check nogood-hits 0 '"ng":5,' "$SOLVER" --format json nogood.nl
+check no-nogood 0 "result:solved, nodes:737," "$SOLVER" --no-nogood nogood.nl
+"$SOLVER" --format dirs nogood.nl > "$WORK/nogood.dirs"
+check no-nogood-board 0 "$(cat "$WORK/nogood.dirs")" "$SOLVER" --no-nogood --format dirs nogood.nl
+check nogood-jobs 0 "result:solved, nodes:684," "$SOLVER" --jobs 2 nogood.nl
+check nogood-unsat 1 "result:unsat, nodes:517," "$SOLVER" nogood-unsat.nl
+check nogood-unsat-hits 1 '"ng":6,' "$SOLVER" --format json nogood-unsat.nl
+check no-nogood-unsat 1 "result:unsat, nodes:550," "$SOLVER" --no-nogood nogood-unsat.nl
+
+# counting
+check count 0 "result:solved, nodes:76, elapsed:" "$SOLVER" --count ../sample.nl
+check count-solutions 0 "solutions:1" "$SOLVER" --count ../sample.nl
+check count-no-symmetry 0 "solutions:1" "$SOLVER" --count --no-symmetry ../sample.nl
+check count-unsat 1 "solutions:0" "$SOLVER" --count unsat.nl
+
+# budgets and checkpoints
+check budget 2 "result:budget exhausted (nodes), nodes:3000," "$SOLVER" --max-nodes 3000 hard.nl
+check checkpoint 2 "result:budget exhausted (nodes), nodes:3000," \
+	"$SOLVER" --checkpoint "$WORK/hard.ck" --max-nodes 3000 hard.nl
+check resume 1 "result:unsat, nodes:8456," "$SOLVER" --resume "$WORK/hard.ck" hard.nl
+
+# result cache
+check cache-store 0 "result:solved, nodes:59," "$SOLVER" --cache "$WORK/r.cache" ../sample.nl
+check cache-hit 0 "cache:hit" "$SOLVER" --cache "$WORK/r.cache" ../sample.nl
+check cache-hit-nodes 0 "result:solved, nodes:1," "$SOLVER" --cache "$WORK/r.cache" ../sample.nl
+check rotated 0 "result:solved, nodes:71," "$SOLVER" rotated.nl
+check cache-rotated 0 "cache:hit, sym:1" "$SOLVER" --cache "$WORK/r.cache" rotated.nl
+
+# batch and binary format
+check batch 1 "batch:3, solved:2, unsat:1, budget:0, canceled:0, errors:0" "$SOLVER" --batch batch.nl
+check convert 0 "converted:3, errors:0" "$SOLVER" --convert "$WORK/b.bin" batch.nl
+check record 0 "result:solved, nodes:23," "$SOLVER" --record 2 "$WORK/b.bin"
+check record-unsat 1 "result:unsat, nodes:1," "$SOLVER" --record 1 "$WORK/b.bin"
+check output 1 "batch:3, solved:2, unsat:1" "$SOLVER" --batch --output "$WORK/o.bin" batch.nl
+check convert-back 0 "converted:3, errors:0" "$SOLVER" --convert "$WORK/o.nl" "$WORK/o.bin"
+check solution-paths 0 "path '4', [4,4], [4,3]" cat "$WORK/o.nl"
+check solved-paths 1 "batch:3, solved:2, unsat:1, budget:0, canceled:0, errors:0" "$SOLVER" --batch "$WORK/o.nl"
+
+# errors
+check no-file 4 "" "$SOLVER" no-such-file.nl
+check bad-option 4 "" "$SOLVER" --max-nodes x ../sample.nl
+: > "$WORK/empty.nl"
+check no-size 4 "empty.nl : size required." "$SOLVER" "$WORK/empty.nl"
+check batch-no-size 4 "batch:0, solved:0, unsat:0, budget:0, canceled:0, errors:1" "$SOLVER" --batch "$WORK/empty.nl"
+{ echo "link '1', [0,0], [1,1]"; cat ../sample.nl; } > "$WORK/lead.nl"
+check batch-lead 4 "batch:2, solved:1, unsat:0, budget:0, canceled:0, errors:1" "$SOLVER" --batch "$WORK/lead.nl"
+
+# server
+if command -v python3 > /dev/null 2>&1; then
+
+	client() {
+		python3 -c '
+import socket, sys
+s = socket.socket(socket.AF_UNIX)
+s.connect(sys.argv[1])
+s.settimeout(10)
+s.sendall(sys.stdin.buffer.read())
+while True:
+    d = s.recv(65536)
+    if not d:
+        break
+    sys.stdout.buffer.write(d)
+' "$WORK/s.sock"
+	}
+
+	"$SOLVER" --server "$WORK/s.sock" --workers 2 > "$WORK/server.log" 2>&1 &
+	SERVER=$!
+	for i in 1 2 3 4 5 6 7 8 9 10; do
+		[ -S "$WORK/s.sock" ] && break
+		sleep 0.2
+	done
+
+	{ echo solve; cat ../sample.nl; echo end; echo quit; } > "$WORK/req"
+	check server-solve 0 "result:solved, nodes:59," client < "$WORK/req"
+
+	{ echo "solve max-nodes=x"; cat ../sample.nl; echo end; echo quit; } > "$WORK/req"
+	check server-bad-budget 0 "max-nodes=x : a number of 0 or more required." client < "$WORK/req"
+
+	{ echo "solve max-nodes=10"; cat hard.nl; echo end; echo quit; } > "$WORK/req"
+	check server-budget 0 "result:budget exhausted (nodes)," client < "$WORK/req"
+
+	# the header and the only record of small.nl
+	"$SOLVER" --convert "$WORK/s.bin" small.nl > /dev/null
+	{ echo "solve binary"; head -c 8 "$WORK/s.bin"
+	  len=$(od -An -tu2 -j8 -N2 "$WORK/s.bin" | tr -d ' ')
+	  tail -c +9 "$WORK/s.bin" | head -c $((len + 2)); echo; echo end; echo quit; } > "$WORK/req"
+	check server-binary 0 "result:solved, nodes:23," client < "$WORK/req"
+
+	{ echo stats; echo quit; } > "$WORK/req"
+	check server-stats 0 "requests:4, solved:2, unsat:0, budget:1, canceled:0, errors:1," client < "$WORK/req"
+
+	# idle connections do not hold the workers, so stats is still answered
+	idle() {
+		python3 -c '
+import socket, sys, time
+s = socket.socket(socket.AF_UNIX)
+s.connect(sys.argv[1])
+time.sleep(5)
+' "$WORK/s.sock" &
+	}
+	idle; IDLE1=$!
+	idle; IDLE2=$!
+	sleep 0.5
+	{ echo stats; echo quit; } > "$WORK/req"
+	check server-idle 0 "busy:0, queued:0, clients:3, workers:2," client < "$WORK/req"
+	kill "$IDLE1" "$IDLE2"
+
+	kill "$SERVER"
+	wait "$SERVER" 2> /dev/null
+else
+	echo "python3 not found, server checks skipped"
+fi
+
+echo "pass:$PASS, fail:$FAIL"
+[ "$FAIL" = 0 ]
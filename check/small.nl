@@ -0,0 +1,5 @@
+size 5
+link '1', [0,2], [0,4]
+link '2', [3,1], [0,3]
+link '3', [0,0], [0,1]
+link '4', [4,4], [4,3]
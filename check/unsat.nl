@@ -0,0 +1,4 @@
+size 5
+link '1', [1,3], [1,4]
+link '2', [4,1], [4,2]
+link '3', [1,0], [1,2]
@@ -0,0 +1,8 @@
+size 7
+link '1', [0,0], [3,0], [6,2]
+link '2', [5,1], [6,6]
+link '3', [0,5], [4,5]
+link '4', [3,2], [0,6]
+link '5', [1,3], [4,3]
+link '6', [0,1], [2,2]
+path '1', [6,2], [6,1], [6,0], [5,0], [4,0], [3,0], [2,0]
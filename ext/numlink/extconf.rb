@@ -0,0 +1,6 @@
+# encoding: utf-8
+require 'mkmf'
+
+# エンジンは NumLinkSolver.c をそのまま取り込んでビルドする
+have_library('pthread')
+create_makefile('numlink_ext')
@@ -0,0 +1,340 @@
+#include <ruby.h>
+#include <ruby/thread.h>
+#include <pthread.h>
+
+// main GŴ܂܎荞
+#define NUMLINK_LIBRARY
+#include "../../NumLinkSolver.c"
+#include "../../Utils.c"
+
+#define EXT_DEF_NAME "definition"
+#define EXT_STACK_SIZE (256 * 1024 * 1024)
+#define EXT_MSG_LEN 4096
+
+typedef struct __EXT_RESULT {
+	char cStopReason;
+	long iNodes;
+	long iSolutions;
+	PATH_DEF pstPaths[MAX_DEFS + 1];
+} EXT_RESULT, *pEXT_RESULT;
+
+typedef struct __EXT_CALL {
+	const char *pcDef;
+	long iDefLen;
+	long iMaxNodes;
+	double dTimeLimit;
+	char cCount;
+	pid_t iPid;
+	int iResultFd;
+	int iMsgFd;
+	EXT_RESULT stResult;
+	long iResultLen;
+	char pcMsg[EXT_MSG_LEN + 1];
+	int iMsgLen;
+} EXT_CALL, *pEXT_CALL;
+
+static VALUE gvNumberLink;
+static VALUE gvError;
+
+static VALUE ext_solve(
+	VALUE vSelf,
+	VALUE vDef,
+	VALUE vMaxNodes,
+	VALUE vTimeLimit,
+	VALUE vCount
+);
+static void run_child(
+	pEXT_CALL pstCall,
+	int iResultFd
+);
+static void *solve_child(
+	void *pvCall
+);
+static void *wait_child(
+	void *pvCall
+);
+static void cancel_child(
+	void *pvCall
+);
+static VALUE make_result(
+	pEXT_CALL pstCall
+);
+
+void Init_numlink_ext(void) {
+
+	VALUE vNative;
+
+	init_tables();
+
+	gvNumberLink = rb_define_module("NumberLink");
+	gvError = rb_define_class_under(gvNumberLink, "Error", rb_eStandardError);
+	vNative = rb_define_module_under(gvNumberLink, "Native");
+	rb_define_module_function(vNative, "solve", ext_solve, 4);
+}
+
+static VALUE ext_solve(
+	VALUE vSelf,
+	VALUE vDef,
+	VALUE vMaxNodes,
+	VALUE vTimeLimit,
+	VALUE vCount
+) {
+
+	pEXT_CALL pstCall;
+	int piResult[2];
+	int piMsg[2];
+	VALUE vResult;
+
+	StringValue(vDef);
+
+	pstCall = ALLOC(EXT_CALL);
+	memset(pstCall, '\0', sizeof(EXT_CALL));
+	pstCall->pcDef = RSTRING_PTR(vDef);
+	pstCall->iDefLen = RSTRING_LEN(vDef);
+	pstCall->iMaxNodes = NUM2LONG(vMaxNodes);
+	pstCall->dTimeLimit = NUM2DBL(vTimeLimit);
+	pstCall->cCount = RTEST(vCount) ? FLG_ON : FLG_OFF;
+
+	if (pipe(piResult) != 0) {
+		xfree(pstCall);
+		rb_sys_fail("pipe");
+	}
+	if (pipe(piMsg) != 0) {
+		close(piResult[0]);
+		close(piResult[1]);
+		xfree(pstCall);
+		rb_sys_fail("pipe");
+	}
+
+	// GW͑ϐœ̂ŁAтɎqvZX𕪂
+	fflush(stdout);
+	pstCall->iPid = fork();
+	if (pstCall->iPid == 0) {
+		close(piResult[0]);
+		close(piMsg[0]);
+		dup2(piMsg[1], STDOUT_FILENO);
+		close(piMsg[1]);
+		run_child(pstCall, piResult[1]);
+		_exit(0);
+	}
+
+	close(piResult[1]);
+	close(piMsg[1]);
+
+	if (pstCall->iPid < 0) {
+		close(piResult[0]);
+		close(piMsg[0]);
+		xfree(pstCall);
+		rb_sys_fail("fork");
+	}
+
+	// ҂Ԃ GVL Aق̃Xbh悤ɂ
+	pstCall->iResultFd = piResult[0];
+	pstCall->iMsgFd = piMsg[0];
+	rb_thread_call_without_gvl(wait_child, pstCall, cancel_child, pstCall);
+
+	close(piResult[0]);
+	close(piMsg[0]);
+
+	if (pstCall->iResultLen != sizeof(EXT_RESULT)) {
+		vResult = rb_str_new(pstCall->pcMsg, pstCall->iMsgLen);
+		xfree(pstCall);
+		rb_thread_check_ints();
+		rb_raise(gvError, "%s", StringValueCStr(vResult));
+	}
+
+	vResult = make_result(pstCall);
+	xfree(pstCall);
+
+	return vResult;
+}
+
+static void run_child(
+	pEXT_CALL pstCall,
+	int iResultFd
+) {
+
+	pthread_attr_t stAttr;
+	pthread_t stThread;
+	char *pcBuf;
+	long iLen;
+
+	pstCall->iResultFd = iResultFd;
+
+	// Ruby ̃Xbh̃X^bNł͐[T܂Ȃ̂ŁALX^bNŉ
+	pthread_attr_init(&stAttr);
+	pthread_attr_setstacksize(&stAttr, EXT_STACK_SIZE);
+	if (pthread_create(&stThread, &stAttr, solve_child, pstCall) != 0) {
+		printf("solver thread can not be started.");
+		fflush(stdout);
+		return;
+	}
+	pthread_join(stThread, NULL);
+
+	pcBuf = (char *) &(pstCall->stResult);
+	for (iLen = 0; pstCall->iResultLen > 0 && iLen < (long) sizeof(EXT_RESULT); ) {
+		ssize_t iWritten = write(iResultFd, pcBuf + iLen, sizeof(EXT_RESULT) - iLen);
+		if (iWritten <= 0) {
+			break;
+		}
+		iLen += iWritten;
+	}
+	fflush(stdout);
+}
+
+static void *solve_child(
+	void *pvCall
+) {
+
+	pEXT_CALL pstCall = (pEXT_CALL) pvCall;
+	pLINK_DEF pstLinkDef;
+	pPATH_DEF pstPath;
+
+	gcQuiet = FLG_ON;
+	gcFormat = FORMAT_DIRS;
+	gcPresolve = FLG_ON;
+	gcSymmetry = FLG_ON;
+	gcNogood = FLG_ON;
+	gcCount = pstCall->cCount;
+	gcOrder = ORDER_FIXED;
+	giJobs = 1;
+	giPortfolio = 1;
+	giDistribute = 1;
+	gcRandomize = FLG_OFF;
+	glSeed = 1;
+	gcRestart = RESTART_NONE;
+	giRestartBase = RESTART_BASE;
+	giMaxNodes = pstCall->iMaxNodes;
+	gdTimeLimit = pstCall->dTimeLimit;
+
+	clear_def();
+	if (parse_lines(pstCall->pcDef, pstCall->pcDef + pstCall->iDefLen, EXT_DEF_NAME, NULL) != RET_OK) {
+		return NULL;
+	}
+	if (gcSize < 0) {
+		printf("%s : size required.", EXT_DEF_NAME);
+		return NULL;
+	}
+
+	init_globals();
+	set_signal(SIGTERM, on_signal);
+
+	if (solve() != RET_OK) {
+		return NULL;
+	}
+
+	pstCall->stResult.cStopReason = gcStopReason;
+	pstCall->stResult.iNodes = giNodeCases;
+	pstCall->stResult.iSolutions = giSolutionCases;
+	if (gcStopReason == STOP_SOLVED) {
+		for (pstLinkDef = gpstLinkDefs, pstPath = pstCall->stResult.pstPaths; HAS_LINK(pstLinkDef); pstLinkDef++, pstPath++) {
+			if (get_solution_path(&gstSolution, pstLinkDef, pstPath) != RET_OK) {
+				return NULL;
+			}
+		}
+	}
+	pstCall->iResultLen = sizeof(EXT_RESULT);
+
+	return NULL;
+}
+
+static void *wait_child(
+	void *pvCall
+) {
+
+	pEXT_CALL pstCall = (pEXT_CALL) pvCall;
+	struct pollfd pstPolls[2];
+	char pcDrain[256];
+	ssize_t iLen;
+	int i;
+
+	pstPolls[0].fd = pstCall->iResultFd;
+	pstPolls[1].fd = pstCall->iMsgFd;
+	pstPolls[0].events = POLLIN;
+	pstPolls[1].events = POLLIN;
+
+	// ʂƃbZ[W̗܂œǂ
+	while (pstPolls[0].fd >= 0 || pstPolls[1].fd >= 0) {
+
+		if (poll(pstPolls, 2, -1) < 0) {
+			if (errno == EINTR) {
+				continue;
+			}
+			break;
+		}
+
+		for (i = 0; i < 2; i++) {
+			if (pstPolls[i].fd < 0 || pstPolls[i].revents == 0) {
+				continue;
+			}
+			if (i == 0) {
+				iLen = read(pstPolls[i].fd, (char *) &(pstCall->stResult) + pstCall->iResultLen, sizeof(EXT_RESULT) - pstCall->iResultLen);
+				if (iLen > 0) {
+					pstCall->iResultLen += iLen;
+				}
+			} else if (pstCall->iMsgLen < EXT_MSG_LEN) {
+				iLen = read(pstPolls[i].fd, pstCall->pcMsg + pstCall->iMsgLen, EXT_MSG_LEN - pstCall->iMsgLen);
+				if (iLen > 0) {
+					pstCall->iMsgLen += iLen;
+				}
+			} else {
+				iLen = read(pstPolls[i].fd, pcDrain, sizeof(pcDrain));
+			}
+			if (iLen <= 0 && !(iLen < 0 && errno == EINTR)) {
+				pstPolls[i].fd = -1;
+			}
+		}
+	}
+
+	waitpid(pstCall->iPid, NULL, 0);
+	pstCall->pcMsg[pstCall->iMsgLen] = '\0';
+
+	return NULL;
+}
+
+static void cancel_child(
+	void *pvCall
+) {
+
+	pEXT_CALL pstCall = (pEXT_CALL) pvCall;
+
+	// q SIGTERM ŎƂĎ~܂AʂԂ
+	kill(pstCall->iPid, SIGTERM);
+}
+
+static VALUE make_result(
+	pEXT_CALL pstCall
+) {
+
+	static const char *ppcResults[] = {
+		"unsat",
+		"solved",
+		"budget_nodes",
+		"budget_time",
+		"budget_memory",
+		"canceled"
+	};
+
+	VALUE vPaths;
+	VALUE vPoints;
+	pPATH_DEF pstPath;
+	pPOINT pstPoint;
+
+	// {N => [[s, ], ...]} ̌`ɂ
+	vPaths = rb_hash_new();
+	for (pstPath = pstCall->stResult.pstPaths; HAS_LINK(pstPath); pstPath++) {
+		vPoints = rb_ary_new();
+		for (pstPoint = pstPath->pstPoints; HAS_POINT(pstPoint); pstPoint++) {
+			rb_ary_push(vPoints, rb_assoc_new(INT2FIX(pstPoint->cRow), INT2FIX(pstPoint->cCol)));
+		}
+		rb_hash_aset(vPaths, rb_str_new_cstr(pstPath->pcLinkName), vPoints);
+	}
+
+	return rb_ary_new3(
+		4,
+		ID2SYM(rb_intern(ppcResults[(int) pstCall->stResult.cStopReason])),
+		LONG2NUM(pstCall->stResult.iNodes),
+		LONG2NUM(pstCall->stResult.iSolutions),
+		vPaths
+	);
+}
@@ -0,0 +1,77 @@
+# encoding: utf-8
+require 'numlink_ext'
+
+# = NumberLink Solver Module (C engine)
+module NumberLink
+  # = NumberLink problem definition
+  unless const_defined?(:Definition)
+    class Definition < Struct.new(
+      :sz,
+      :link_tbl
+    )
+      def initialize
+        super(0, {})
+      end
+
+      def size(value)
+        self.sz = value
+      end
+
+      def link(link_name, *points)
+        link_tbl[link_name] = points
+      end
+    end
+  end
+
+  # = Definition as the datafile text for the C engine
+  class Definition
+    def path(link_name, *points)
+      (@path_list ||= []) << [link_name, points]
+    end
+
+    def to_datafile
+      lines = ["size #{sz}"]
+      link_tbl.each { |name, points| lines << def_line('link', name, points) }
+      (@path_list || []).each { |name, points| lines << def_line('path', name, points) }
+      lines.join("\n") << "\n"
+    end
+
+    private
+
+    def def_line(kind, name, points)
+      "#{kind} '#{name}', " + points.map { |row, col| "[#{row},#{col}]" } * ', '
+    end
+  end
+
+  # = Result of the C engine
+  class Result < Struct.new(
+    :result,
+    :nodes,
+    :solutions,
+    :paths,
+    :grid
+  )
+    def solved?
+      result == :solved
+    end
+  end
+
+  module_function
+
+  # Definition is given in the datafile DSL, as a string or a block
+  def solve(code = nil, max_nodes: 0, time_limit: 0, count: false, &blk)
+    definition = Definition.new
+    code ? definition.instance_eval(code) : definition.instance_eval(&blk)
+    result, nodes, solutions, paths = Native.solve(
+      definition.to_datafile, max_nodes, time_limit.to_f, count
+    )
+    Result.new(result, nodes, solutions, paths, to_grid(definition.sz, paths))
+  end
+
+  def to_grid(sz, paths)
+    return nil if paths.empty?
+    grid = Array.new(sz) { Array.new(sz) }
+    paths.each { |name, points| points.each { |row, col| grid[row][col] = name } }
+    grid
+  end
+end